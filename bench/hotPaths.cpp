@@ -0,0 +1,488 @@
+/**
+ * @file hotPaths.cpp
+ * @brief Microbenchmarks of the engine's hot paths: map and level loading, collision queries,
+ * sprite animation and slope polyline parsing.
+ *
+ * Runs headless on SDL's dummy video driver, from the build directory like the game (resources are
+ * read from ../res). Each benchmark is timed over enough iterations to last --min-time seconds,
+ * --repetitions times, and the results can be written to JSON to be compared across commits.
+ *
+ * Usage: bench_hotPaths [--json FILE] [--filter TEXT] [--min-time SECONDS] [--repetitions N]
+ */
+
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "camera.h"
+#include "graphics.h"
+#include "level.h"
+#include "levelCache.h"
+#include "mapData.h"
+#include "player.h"
+#include "enemy.h"
+#include "utils.h"
+
+namespace{
+    const std::string MAP_DIRECTORY = "../res/maps/";
+    const int QUERY_COUNT = 1024; // boxes swept across the map by the collision benchmarks
+    const int SPRITE_COUNT = 1000; // sprites updated and drawn by the animation benchmarks
+
+    /**
+     * @struct Benchmark
+     * @brief A named piece of work, run a given number of times per call.
+     */
+    struct Benchmark {
+        std::string Name; ///< Name shown in the results, "group/case".
+        std::function<void(long long)> Run; ///< Runs the measured work that many times.
+    };
+
+    /**
+     * @struct Result
+     * @brief Timings of one benchmark over its repetitions.
+     */
+    struct Result {
+        std::string Name; ///< Name of the benchmark.
+        long long Iterations; ///< Iterations per repetition.
+        double MeanTime; ///< Mean time per iteration, in nanoseconds.
+        double MedianTime; ///< Median time per iteration, in nanoseconds.
+        double MinTime; ///< Fastest repetition's time per iteration, in nanoseconds.
+    };
+
+    /**
+     * @struct Settings
+     * @brief Command line settings of the run.
+     */
+    struct Settings {
+        std::string JsonPath; ///< File the results are written to, empty for none.
+        std::string Filter; ///< Only benchmarks whose name contains it are run.
+        double MinTime; ///< Seconds a repetition must last at least.
+        int Repetitions; ///< Times each benchmark is measured.
+    };
+
+    //keeps the optimizer from dropping work whose result is otherwise unused
+    volatile size_t sink = 0;
+
+    template <class T>
+    inline void keep(const T &p_value){
+        sink = sink + (size_t)p_value;
+    }
+
+    double measure(const Benchmark &p_benchmark, long long p_iterations){
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        p_benchmark.Run(p_iterations);
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    Result runBenchmark(const Benchmark &p_benchmark, const Settings &p_settings){
+        //grow the iteration count until one run lasts the minimum time, warming caches on the way
+        long long iterations = 1;
+        double seconds = measure(p_benchmark, iterations);
+        while(seconds < p_settings.MinTime && iterations < (1LL << 40)){
+            double growth = seconds > 0.0 ? p_settings.MinTime * 1.4 / seconds : 10.0;
+            iterations = (long long)(iterations * std::min(10.0, std::max(2.0, growth)));
+            seconds = measure(p_benchmark, iterations);
+        }
+
+        std::vector<double> times;
+        times.push_back(seconds * 1e9 / iterations);
+        for(int i = 1; i < p_settings.Repetitions; i++){
+            times.push_back(measure(p_benchmark, iterations) * 1e9 / iterations);
+        }
+
+        Result result;
+        result.Name = p_benchmark.Name;
+        result.Iterations = iterations;
+        result.MeanTime = 0.0;
+        for(int i = 0; i < times.size(); i++){
+            result.MeanTime += times[i] / times.size();
+        }
+        std::sort(times.begin(), times.end());
+        result.MedianTime = times.size() % 2 == 1 ? times[times.size() / 2] :
+            (times[times.size() / 2 - 1] + times[times.size() / 2]) / 2.0;
+        result.MinTime = times.front();
+        return result;
+    }
+
+    std::string escapeJson(const std::string &p_text){
+        std::string escaped;
+        for(int i = 0; i < p_text.size(); i++){
+            if(p_text[i] == '"' || p_text[i] == '\\'){
+                escaped += '\\';
+            }
+            escaped += p_text[i];
+        }
+        return escaped;
+    }
+
+    bool writeJson(const std::string &p_filePath, const std::vector<Result> &p_results, const Settings &p_settings,
+            const char* p_executable){
+        std::ofstream out(p_filePath.c_str(), std::ios::trunc);
+        if(!out){
+            printf("\nError: Unable to write %s\n", p_filePath.c_str());
+            return false;
+        }
+
+        char date[32];
+        std::time_t now = std::time(NULL);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+#ifdef NDEBUG
+        const char* buildType = "release";
+#else
+        const char* buildType = "debug";
+#endif
+
+        //same layout as Google Benchmark's, so its compare tools read it
+        out << "{\n  \"context\": {\n"
+            << "    \"date\": \"" << date << "\",\n"
+            << "    \"executable\": \"" << escapeJson(p_executable) << "\",\n"
+            << "    \"library_build_type\": \"" << buildType << "\",\n"
+            << "    \"min_time\": " << p_settings.MinTime << ",\n"
+            << "    \"repetitions\": " << p_settings.Repetitions << "\n"
+            << "  },\n  \"benchmarks\": [\n";
+        for(int i = 0; i < p_results.size(); i++){
+            const Result &result = p_results[i];
+            out << "    {\n"
+                << "      \"name\": \"" << escapeJson(result.Name) << "\",\n"
+                << "      \"iterations\": " << result.Iterations << ",\n"
+                << "      \"real_time\": " << result.MeanTime << ",\n"
+                << "      \"median_time\": " << result.MedianTime << ",\n"
+                << "      \"min_time\": " << result.MinTime << ",\n"
+                << "      \"time_unit\": \"ns\"\n"
+                << "    }" << (i + 1 < p_results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+        return out.good();
+    }
+
+    /**
+     * @brief Builds a square map by repeating the tiles of a real one, with p_objectCount collision
+     * rectangles, slopes, doors and bats spread evenly over it.
+     */
+    std::shared_ptr<MapData> makeSyntheticMap(const MapData &p_source, int p_size, int p_objectCount){
+        std::shared_ptr<MapData> map = std::make_shared<MapData>();
+        map->Size = Vector2f(p_size, p_size);
+        map->TileSize = p_source.TileSize;
+        map->Tilesets = p_source.Tilesets;
+        map->Animations = p_source.Animations;
+        map->SolidGids = p_source.SolidGids;
+
+        int sourceWidth = std::max(p_source.Size.x, 1);
+        int sourceHeight = std::max(p_source.Size.y, 1);
+        std::vector<uint32_t> sourceGids;
+        for(int l = 0; l < p_source.Layers.size(); l++){
+            p_source.getLayerGids(l, sourceGids);
+            LayerData layer;
+            layer.Collision = p_source.Layers[l].Collision;
+            layer.Gids.resize((size_t)p_size * p_size);
+            for(int y = 0; y < p_size; y++){
+                for(int x = 0; x < p_size; x++){
+                    size_t source = (size_t)(y % sourceHeight) * sourceWidth + x % sourceWidth;
+                    layer.Gids[(size_t)y * p_size + x] = source < sourceGids.size() ? sourceGids[source] : 0;
+                }
+            }
+            map->Layers.push_back(std::move(layer));
+        }
+
+        int tileWidth = map->TileSize.x * globals::SPRITE_SCALE;
+        int tileHeight = map->TileSize.y * globals::SPRITE_SCALE;
+        int columns = std::max(1, (int)std::ceil(std::sqrt((double)p_objectCount)));
+        int spacingX = std::max(1, p_size * tileWidth / columns);
+        int spacingY = std::max(1, p_size * tileHeight / columns);
+        for(int i = 0; i < p_objectCount; i++){
+            int x = (i % columns) * spacingX;
+            int y = (i / columns) * spacingY;
+            map->CollisionRects.push_back(Rectangle(x, y + spacingY / 2, spacingX / 2, tileHeight));
+            map->Slopes.push_back(Slope(Vector2f(x + spacingX / 2, y), Vector2f(x + spacingX, y + tileHeight)));
+
+            DoorData door;
+            door.Rect = Rectangle((x + spacingX / 4) / globals::SPRITE_SCALE, y / globals::SPRITE_SCALE,
+                tileWidth / globals::SPRITE_SCALE, tileHeight / globals::SPRITE_SCALE);
+            door.Destination = "Map 2";
+            map->Doors.push_back(door);
+
+            EnemyData enemy;
+            enemy.Name = "bat";
+            enemy.Position = Vector2f(x + spacingX / 4, y + spacingY / 4);
+            map->Enemies.push_back(enemy);
+        }
+        map->SpawnPoint = Vector2f(p_size * tileWidth / 2, p_size * tileHeight / 2);
+        map->computeSourcePositions();
+        return map;
+    }
+
+    std::shared_ptr<const LevelTemplate> makeTemplate(const std::string &p_name, const std::shared_ptr<const MapData> &p_map,
+            Graphics &p_graphics){
+        std::vector<Tileset> tilesets;
+        for(int i = 0; i < p_map->Tilesets.size(); i++){
+            tilesets.push_back(Tileset(p_graphics.loadTexture(p_map->Tilesets[i].ImagePath), p_map->Tilesets[i].FirstGid));
+        }
+        return LevelCache::makeTemplate(p_name, p_map, tilesets);
+    }
+
+    //player sized boxes on a grid covering the whole level, so every query lands somewhere different
+    std::vector<Rectangle> makeQueries(Vector2f p_levelSize){
+        std::vector<Rectangle> queries;
+        int side = (int)std::sqrt((double)QUERY_COUNT);
+        for(int i = 0; i < QUERY_COUNT; i++){
+            queries.push_back(Rectangle((i % side) * p_levelSize.x / side, (i / side) * p_levelSize.y / side,
+                16 * globals::SPRITE_SCALE, 16 * globals::SPRITE_SCALE));
+        }
+        return queries;
+    }
+
+    std::string makePolyline(int p_points){
+        std::string points;
+        for(int i = 0; i < p_points; i++){
+            points += (i > 0 ? " " : "") + std::to_string(i * 16) + "," + std::to_string((i % 2) * -8);
+        }
+        return points;
+    }
+
+    void addMapBenchmarks(std::vector<Benchmark> &p_benchmarks, Graphics &p_graphics){
+        const char* MAP_NAMES[] = {"Map 1", "Map 2"};
+        for(int m = 0; m < 2; m++){
+            std::string name = MAP_NAMES[m];
+            std::string tmxPath = MAP_DIRECTORY + name + ".tmx";
+            std::string cookedPath = (std::filesystem::temp_directory_path() / ("bench_" + name + ".cmap")).string();
+            MapData source;
+            if(!MapData::loadTmx(tmxPath, source) || !source.saveCooked(cookedPath)){
+                printf("\nError: Unable to prepare %s, skipping its benchmarks\n", name.c_str());
+                continue;
+            }
+
+            p_benchmarks.push_back({"map_load_tmx/" + name, [tmxPath](long long p_iterations){
+                for(long long i = 0; i < p_iterations; i++){
+                    MapData map;
+                    keep(MapData::loadTmx(tmxPath, map));
+                }
+            }});
+            p_benchmarks.push_back({"map_load_cooked/" + name, [cookedPath](long long p_iterations){
+                for(long long i = 0; i < p_iterations; i++){
+                    MapData map;
+                    keep(MapData::loadCooked(cookedPath, map));
+                }
+            }});
+
+            //a fresh cache loads the map and its textures, like entering a level for the first time
+            p_benchmarks.push_back({"level_load/" + name, [name, &p_graphics](long long p_iterations){
+                for(long long i = 0; i < p_iterations; i++){
+                    LevelCache cache;
+                    Level level = cache.createLevel(name, p_graphics);
+                    keep(level.getDoors().size());
+                }
+            }});
+
+            std::shared_ptr<const LevelTemplate> levelTemplate = makeTemplate(name, std::make_shared<MapData>(source), p_graphics);
+            p_benchmarks.push_back({"level_build/" + name, [levelTemplate, &p_graphics](long long p_iterations){
+                for(long long i = 0; i < p_iterations; i++){
+                    Level level(levelTemplate, p_graphics);
+                    keep(level.getDoors().size());
+                }
+            }});
+        }
+    }
+
+    void addSyntheticMapBenchmarks(std::vector<Benchmark> &p_benchmarks, Graphics &p_graphics, const MapData &p_source){
+        const int SIZES[] = {100, 300, 1000};
+        for(int s = 0; s < 3; s++){
+            int size = SIZES[s];
+            std::string name = "synthetic " + std::to_string(size) + "x" + std::to_string(size);
+            std::shared_ptr<MapData> map = makeSyntheticMap(p_source, size, 100);
+            std::string cookedPath = (std::filesystem::temp_directory_path() /
+                ("bench_synthetic_" + std::to_string(size) + ".cmap")).string();
+            if(!map->saveCooked(cookedPath)){
+                printf("\nError: Unable to write %s\n", cookedPath.c_str());
+                continue;
+            }
+
+            p_benchmarks.push_back({"map_load_cooked/" + name, [cookedPath](long long p_iterations){
+                for(long long i = 0; i < p_iterations; i++){
+                    MapData loaded;
+                    keep(MapData::loadCooked(cookedPath, loaded));
+                }
+            }});
+
+            std::shared_ptr<const LevelTemplate> levelTemplate = makeTemplate(name, map, p_graphics);
+            p_benchmarks.push_back({"level_build/" + name, [levelTemplate, &p_graphics](long long p_iterations){
+                for(long long i = 0; i < p_iterations; i++){
+                    Level level(levelTemplate, p_graphics);
+                    keep(level.getDoors().size());
+                }
+            }});
+        }
+    }
+
+    void addCollisionBenchmarks(std::vector<Benchmark> &p_benchmarks, Graphics &p_graphics, const MapData &p_source){
+        const int COUNTS[] = {100, 1000, 10000};
+        for(int c = 0; c < 3; c++){
+            int count = COUNTS[c];
+            std::string suffix = "/" + std::to_string(count);
+
+            //shared by the lambdas below, each query reuses the same hit buffer like the game does
+            std::shared_ptr<Level> level = std::make_shared<Level>(
+                makeTemplate("collisions" + suffix, makeSyntheticMap(p_source, 200, count), p_graphics), p_graphics);
+            std::shared_ptr<std::vector<Rectangle>> queries =
+                std::make_shared<std::vector<Rectangle>>(makeQueries(level->getPixelSize()));
+
+            p_benchmarks.push_back({"check_tile_collisions" + suffix, [level, queries](long long p_iterations){
+                std::vector<Rectangle> hits;
+                for(long long i = 0; i < p_iterations; i++){
+                    level->checkTileCollisions((*queries)[i % QUERY_COUNT], hits);
+                    keep(hits.size());
+                }
+            }});
+            p_benchmarks.push_back({"check_slope_collisions" + suffix, [level, queries](long long p_iterations){
+                std::vector<Slope> hits;
+                for(long long i = 0; i < p_iterations; i++){
+                    level->checkSlopeCollisions((*queries)[i % QUERY_COUNT], hits);
+                    keep(hits.size());
+                }
+            }});
+            p_benchmarks.push_back({"check_door_collisions" + suffix, [level, queries](long long p_iterations){
+                std::vector<Door> hits;
+                for(long long i = 0; i < p_iterations; i++){
+                    level->checkDoorCollisions((*queries)[i % QUERY_COUNT], hits);
+                    keep(hits.size());
+                }
+            }});
+            p_benchmarks.push_back({"check_enemy_collisions" + suffix, [level, queries](long long p_iterations){
+                std::vector<Enemy*> hits;
+                for(long long i = 0; i < p_iterations; i++){
+                    level->checkEnemyCollisions((*queries)[i % QUERY_COUNT], hits);
+                    keep(hits.size());
+                }
+            }});
+        }
+    }
+
+    void addDrawBenchmarks(std::vector<Benchmark> &p_benchmarks, Graphics &p_graphics, const MapData &p_source){
+        const tiledraw::Mode MODES[] = {tiledraw::PER_TILE, tiledraw::BATCHED, tiledraw::CACHED};
+        const char* MODE_NAMES[] = {"per-tile", "batched", "cached"};
+        std::shared_ptr<const LevelTemplate> levelTemplate = makeTemplate("draw", makeSyntheticMap(p_source, 300, 100), p_graphics);
+        for(int m = 0; m < 3; m++){
+            std::shared_ptr<Level> level = std::make_shared<Level>(levelTemplate, p_graphics);
+            level->setTileDrawMode(MODES[m]);
+
+            //one screen in the middle of the map, the cached mode renders its chunks during the first draw
+            std::shared_ptr<Camera> camera = std::make_shared<Camera>();
+            Vector2f size = level->getPixelSize();
+            camera->follow(Rectangle(size.x / 2, size.y / 2, 0, 0), size);
+
+            p_benchmarks.push_back({std::string("level_draw/") + MODE_NAMES[m], [level, camera, &p_graphics](long long p_iterations){
+                for(long long i = 0; i < p_iterations; i++){
+                    level->draw(p_graphics, *camera, 1.0f);
+                }
+                p_graphics.clear();
+            }});
+        }
+    }
+
+    void addAnimationBenchmarks(std::vector<Benchmark> &p_benchmarks, Graphics &p_graphics){
+        std::shared_ptr<std::vector<Bat>> bats = std::make_shared<std::vector<Bat>>();
+        for(int i = 0; i < SPRITE_COUNT; i++){
+            bats->push_back(Bat(p_graphics, Vector2f((i % 40) * 16, (i / 40) * 16)));
+        }
+
+        //one frame's worth of time per update, so frames advance like they do in game
+        p_benchmarks.push_back({"animated_sprite/update", [bats](long long p_iterations){
+            for(long long i = 0; i < p_iterations; i++){
+                (*bats)[i % SPRITE_COUNT].AnimatedSprite::update(1000.0f / 60.0f);
+            }
+        }});
+        p_benchmarks.push_back({"animated_sprite/draw", [bats, &p_graphics](long long p_iterations){
+            for(long long i = 0; i < p_iterations; i++){
+                (*bats)[i % SPRITE_COUNT].AnimatedSprite::draw(p_graphics, (i % 40) * 16, (i / 40 % 25) * 16);
+            }
+            p_graphics.clear();
+        }});
+    }
+
+    void addSplitBenchmarks(std::vector<Benchmark> &p_benchmarks){
+        const int POINTS[] = {2, 16, 256};
+        for(int p = 0; p < 3; p++){
+            std::string polyline = makePolyline(POINTS[p]);
+            //the same two level split the map parser does on a slope's points attribute
+            p_benchmarks.push_back({"utils_split/polyline " + std::to_string(POINTS[p]), [polyline](long long p_iterations){
+                std::vector<std::string> pairs;
+                std::vector<std::string> coordinates;
+                for(long long i = 0; i < p_iterations; i++){
+                    Utils::split(polyline, pairs, ' ');
+                    for(int j = 0; j < pairs.size(); j++){
+                        keep(Utils::split(pairs[j], coordinates, ','));
+                    }
+                }
+            }});
+        }
+    }
+}
+
+int main(int argc, char* argv[]){
+    Settings settings;
+    settings.MinTime = 0.5;
+    settings.Repetitions = 3;
+    for(int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        if(arg == "--json" && i + 1 < argc){
+            settings.JsonPath = argv[++i];
+        } else if(arg == "--filter" && i + 1 < argc){
+            settings.Filter = argv[++i];
+        } else if(arg == "--min-time" && i + 1 < argc){
+            settings.MinTime = std::atof(argv[++i]);
+        } else if(arg == "--repetitions" && i + 1 < argc){
+            settings.Repetitions = std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::cout << "Usage: " << argv[0] << " [--json FILE] [--filter TEXT] [--min-time SECONDS] [--repetitions N]" << std::endl;
+            return 1;
+        }
+    }
+
+    //no display needed, sprites and tiles are drawn in memory by the software renderer
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER);
+
+    std::vector<Result> results;
+    {
+        Graphics graphics(false, true);
+
+        MapData source;
+        if(!MapData::loadTmx(MAP_DIRECTORY + "Map 1.tmx", source)){
+            printf("\nError: Unable to load Map 1, run from the build directory so ../res is found\n");
+            return 1;
+        }
+
+        std::vector<Benchmark> benchmarks;
+        addMapBenchmarks(benchmarks, graphics);
+        addSyntheticMapBenchmarks(benchmarks, graphics, source);
+        addCollisionBenchmarks(benchmarks, graphics, source);
+        addDrawBenchmarks(benchmarks, graphics, source);
+        addAnimationBenchmarks(benchmarks, graphics);
+        addSplitBenchmarks(benchmarks);
+
+        printf("%-44s %14s %14s %12s\n", "Benchmark", "Time (ns)", "Median (ns)", "Iterations");
+        for(int i = 0; i < benchmarks.size(); i++){
+            if(!settings.Filter.empty() && benchmarks[i].Name.find(settings.Filter) == std::string::npos){
+                continue;
+            }
+            Result result = runBenchmark(benchmarks[i], settings);
+            printf("%-44s %14.1f %14.1f %12lld\n", result.Name.c_str(), result.MeanTime, result.MedianTime, result.Iterations);
+            fflush(stdout);
+            results.push_back(result);
+        }
+    }
+
+    bool written = settings.JsonPath.empty() || writeJson(settings.JsonPath, results, settings, argv[0]);
+    SDL_Quit();
+    return written ? 0 : 1;
+}
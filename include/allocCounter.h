@@ -0,0 +1,27 @@
+/**
+ * @file allocCounter.h
+ * @brief Counts heap allocations made through the global operator new.
+ */
+
+#ifndef ALLOCCOUNTER_H
+#define ALLOCCOUNTER_H
+
+/**
+ * @namespace allocCounter
+ * @brief Access to the calling thread's allocation counter.
+ * 
+ * src/allocCounter.cpp replaces the global operator new, so every allocation made with new,
+ * including the ones done by standard containers, is counted. Each thread has its own count, so
+ * sampling the counter before and after a piece of code shows whether that code touched the heap,
+ * regardless of what the worker threads allocate meanwhile.
+ */
+namespace allocCounter {
+    /**
+     * @brief Gets the number of allocations made by the calling thread since it started.
+     * 
+     * @return unsigned long long: The allocation count.
+     */
+    unsigned long long getCount();
+}
+
+#endif /* ALLOCCOUNTER_H */
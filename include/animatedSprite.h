@@ -54,7 +54,7 @@ public:
      * @brief Updates the sprite animation based on elapsed time.
      * @param p_elapsedTime Time elapsed since the last update.
      */
-    void update(int p_elapsedTime);
+    void update(float p_elapsedTime);
 
     /**
      * @brief Draws the sprite at the given position.
@@ -37,17 +37,32 @@ public:
      * 
      * @param p_elapsedTime Time elapsed since the last update call in milliseconds.
      */
-    void update(int p_elapsedTime);
+    void update(float p_elapsedTime);
 
     /**
      * @brief Draws the animated tile to the screen.
      * 
      * @param p_graphics Reference to the Graphics object used for rendering.
+     * @param p_camera Camera converting the tile's world position to the screen.
      */
-    void draw(Graphics &p_graphics);
+    void draw(Graphics &p_graphics, const Camera &p_camera) const;
+
+    /**
+     * @brief Gets the index of the animation frame currently shown.
+     * 
+     * @return int: The current frame.
+     */
+    inline int getFrame() const { return this->_tileToDraw; }
+
+    /**
+     * @brief Gets the position in the tileset of the frame currently shown.
+     * 
+     * @return Vector2f: The tileset position of the current frame.
+     */
+    inline Vector2f getCurrentTilesetPosition() const { return this->_tilesetPositions[this->_tileToDraw]; }
 
 protected:
-    int _amountOfTime = 0; ///< Accumulated time since the last frame change.
+    float _amountOfTime = 0; ///< Time left before the next frame change.
     bool _notDone = false; ///< Flag indicating whether the animation is still running.
 
 private:
@@ -0,0 +1,94 @@
+/**
+ * @file camera.h
+ * @brief Defines the Camera class, which maps world coordinates to screen coordinates.
+ */
+
+#ifndef CAMERA_H
+#define CAMERA_H
+
+#include "globals.h"
+#include "rectangle.h"
+
+/**
+ * @class Camera
+ * @brief The part of the world shown on the screen.
+ * 
+ * The camera is centered on a target (usually the player) and clamped to the level bounds,
+ * so it never shows anything outside the level when the level is larger than the screen.
+ * Drawing code converts world positions with toScreenX()/toScreenY() and skips anything
+ * for which isVisible() returns false.
+ */
+class Camera {
+public:
+    /**
+     * @brief Default constructor. The camera shows the top left corner of the world.
+     */
+    Camera();
+
+    /**
+     * @brief Centers the camera on a target, keeping it inside the level.
+     * 
+     * @param p_target The rectangle to follow, in world pixels.
+     * @param p_levelSize The size of the level in world pixels.
+     */
+    void follow(const Rectangle &p_target, Vector2f p_levelSize);
+
+    /**
+     * @brief Gets the world x-coordinate shown at the left edge of the screen.
+     * 
+     * @return int: The x-coordinate of the camera.
+     */
+    inline int getX() const { return this->_x; }
+
+    /**
+     * @brief Gets the world y-coordinate shown at the top edge of the screen.
+     * 
+     * @return int: The y-coordinate of the camera.
+     */
+    inline int getY() const { return this->_y; }
+
+    /**
+     * @brief Converts a world x-coordinate to a screen x-coordinate.
+     * 
+     * @param p_x The world x-coordinate.
+     * @return int: The screen x-coordinate.
+     */
+    inline int toScreenX(float p_x) const { return (int)p_x - this->_x; }
+
+    /**
+     * @brief Converts a world y-coordinate to a screen y-coordinate.
+     * 
+     * @param p_y The world y-coordinate.
+     * @return int: The screen y-coordinate.
+     */
+    inline int toScreenY(float p_y) const { return (int)p_y - this->_y; }
+
+    /**
+     * @brief Gets the area of the world covered by the screen.
+     * 
+     * @return Rectangle: The visible area, in world pixels.
+     */
+    inline Rectangle getView() const {
+        return Rectangle(this->_x, this->_y, globals::SCREEN_WIDTH, globals::SCREEN_HEIGHT);
+    }
+
+    /**
+     * @brief Checks whether a world rectangle is at least partly on the screen.
+     * 
+     * @param p_rect The rectangle to check, in world pixels.
+     * @return bool: True if the rectangle overlaps the screen.
+     */
+    inline bool isVisible(const Rectangle &p_rect) const {
+        return
+            p_rect.getRight() > this->_x &&
+            p_rect.getLeft() < this->_x + globals::SCREEN_WIDTH &&
+            p_rect.getBottom() > this->_y &&
+            p_rect.getTop() < this->_y + globals::SCREEN_HEIGHT;
+    }
+
+private:
+    int _x; ///< World x-coordinate of the left edge of the screen.
+    int _y; ///< World y-coordinate of the top edge of the screen.
+};
+
+#endif /* CAMERA_H */
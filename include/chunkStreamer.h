@@ -0,0 +1,142 @@
+/**
+ * @file chunkStreamer.h
+ * @brief Defines the ChunkStreamer class, which keeps the chunks of an infinite map loaded around the player.
+ */
+
+#ifndef CHUNKSTREAMER_H
+#define CHUNKSTREAMER_H
+
+#include "globals.h"
+#include "rectangle.h"
+#include "tile.h"
+#include "animatedTile.h"
+#include "tileBatch.h"
+#include "spatialGrid.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class Graphics;
+class Camera;
+struct LevelTemplate;
+
+/**
+ * @class ChunkStreamer
+ * @brief Decodes the chunks of an infinite map near a focus point on a worker thread, and drops the far ones.
+ *
+ * Chunks within the streaming radius of the focus are queued for the worker, which decodes their payload
+ * and builds their tiles. Chunks past the radius plus one screen are dropped, and their tiles are freed
+ * by the worker too. The extra screen keeps a player walking back and forth over the edge from reloading
+ * the same chunks.
+ */
+class ChunkStreamer {
+public:
+    /**
+     * @brief Starts streaming a map from its spawn point.
+     *
+     * The chunks on screen around the spawn point are decoded synchronously, on the calling thread,
+     * so the level doesn't start empty. Every other chunk is left to the worker thread started here,
+     * which loads them as update() moves the focus.
+     *
+     * @param p_template The level template holding the map's chunks and tilesets.
+     * @param p_radius Number of screens around the focus whose chunks are kept loaded.
+     */
+    ChunkStreamer(const std::shared_ptr<const LevelTemplate> &p_template, int p_radius);
+
+    /**
+     * @brief Stops the worker thread.
+     */
+    ~ChunkStreamer();
+
+    ChunkStreamer(const ChunkStreamer&) = delete;
+    ChunkStreamer &operator=(const ChunkStreamer&) = delete;
+
+    /**
+     * @brief Queues the chunks that came into range, drops those out of range and collects decoded ones.
+     *
+     * @param p_focus The area to stream around (usually the player), in world pixels.
+     * @param p_elapsedTime Time elapsed since the last update, for the animated tiles.
+     */
+    void update(const Rectangle &p_focus, float p_elapsedTime);
+
+    /**
+     * @brief Draws the loaded chunks visible through the camera, layer by layer, animated tiles last.
+     *
+     * @param p_graphics Graphics context used for rendering.
+     * @param p_camera Camera selecting the visible chunks.
+     */
+    void draw(Graphics &p_graphics, const Camera &p_camera);
+
+    /**
+     * @brief Gets the number of chunks currently loaded.
+     *
+     * @return int: The number of loaded chunks.
+     */
+    inline int getResidentCount() const { return this->_residentIds.size(); }
+
+    /**
+     * @brief Gets the number of chunks in the map.
+     *
+     * @return int: The number of chunks.
+     */
+    inline int getChunkCount() const { return this->_chunks.size(); }
+
+private:
+    /**
+     * @struct ChunkTiles
+     * @brief The tiles built from a decoded chunk.
+     */
+    struct ChunkTiles {
+        std::vector<Tile> Tiles; ///< Static tiles of the chunk.
+        std::vector<AnimatedTile> AnimatedTiles; ///< Animated tiles of the chunk.
+    };
+
+    /**
+     * @struct Chunk
+     * @brief A chunk of one layer and its loading state.
+     */
+    struct Chunk {
+        int Layer; ///< Index of the chunk's layer.
+        int Index; ///< Index of the chunk in its layer.
+        Rectangle Bounds; ///< Area covered by the chunk, in world pixels.
+        bool Requested; ///< True while the chunk is queued or being decoded.
+        std::unique_ptr<ChunkTiles> Tiles; ///< The chunk's tiles, null while it isn't loaded.
+    };
+
+    /**
+     * @brief Worker thread body, decoding queued chunks and freeing dropped ones.
+     */
+    void run();
+
+    /**
+     * @brief Decodes a chunk and builds its tiles.
+     *
+     * @param p_id Index of the chunk in _chunks.
+     * @return std::unique_ptr<ChunkTiles>: The chunk's tiles.
+     */
+    std::unique_ptr<ChunkTiles> loadChunk(int p_id) const;
+
+    std::shared_ptr<const LevelTemplate> _template; ///< The streamed map, immutable and shared with the worker.
+    int _radius; ///< Screens around the focus kept loaded.
+
+    std::vector<Chunk> _chunks; ///< Every chunk, layer by layer so ascending ids are in draw order.
+    SpatialGrid _chunkGrid; ///< Broad phase over the chunks' bounds.
+    std::vector<int> _queryIds; ///< Scratch buffer for _chunkGrid queries.
+    std::vector<int> _residentIds; ///< Chunks currently loaded.
+    std::vector<TileBatch> _batches; ///< One batch per tileset, refilled for each layer drawn.
+
+    std::thread _worker; ///< The loading thread.
+    std::mutex _mutex; ///< Guards the queues below.
+    std::condition_variable _wakeUp; ///< Signaled when work is queued or the worker must stop.
+    std::deque<int> _requests; ///< Chunks waiting to be decoded.
+    std::vector<std::pair<int, std::unique_ptr<ChunkTiles>>> _finished; ///< Decoded chunks not collected yet.
+    std::vector<std::unique_ptr<ChunkTiles>> _dropped; ///< Tiles of dropped chunks, waiting to be freed.
+    bool _stopping; ///< Set when the worker must exit.
+};
+
+#endif /* CHUNKSTREAMER_H */
@@ -0,0 +1,79 @@
+/**
+ * @file collisionMask.h
+ * @brief Defines the CollisionMask class, one solidity bit per tile of a level.
+ */
+
+#ifndef COLLISIONMASK_H
+#define COLLISIONMASK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class CollisionMask
+ * @brief Bitmask grid telling which tiles of a level are solid.
+ *
+ * Each row is packed into 64 bit words, so even a huge map costs one bit per cell, and a collision
+ * test only reads the few cells under the tested rectangle whatever the size of the map.
+ */
+class CollisionMask {
+public:
+    /**
+     * @brief Default constructor. Creates a mask without any cell, where nothing is solid.
+     */
+    CollisionMask();
+
+    /**
+     * @brief Constructs a mask where no cell is solid yet.
+     *
+     * @param p_width Number of columns.
+     * @param p_height Number of rows.
+     */
+    CollisionMask(int p_width, int p_height);
+
+    /**
+     * @brief Checks if a cell is solid.
+     *
+     * @param p_x Column of the cell.
+     * @param p_y Row of the cell.
+     * @return bool: True if the cell is solid, false for empty cells and cells outside the mask.
+     */
+    inline bool isSolid(int p_x, int p_y) const {
+        if(p_x < 0 || p_y < 0 || p_x >= this->_width || p_y >= this->_height){
+            return false;
+        }
+        return (this->_words[(size_t)p_y * this->_wordsPerRow + (p_x >> 6)] >> (p_x & 63)) & 1;
+    }
+
+    /**
+     * @brief Marks a cell as solid or empty. Cells outside the mask are ignored.
+     *
+     * @param p_x Column of the cell.
+     * @param p_y Row of the cell.
+     * @param p_solid True to make the cell solid.
+     */
+    void setSolid(int p_x, int p_y, bool p_solid);
+
+    /**
+     * @brief Gets the number of columns.
+     *
+     * @return int: The width of the mask, 0 if the level has no solid tiles.
+     */
+    inline int getWidth() const { return this->_width; }
+
+    /**
+     * @brief Gets the number of rows.
+     *
+     * @return int: The height of the mask.
+     */
+    inline int getHeight() const { return this->_height; }
+
+private:
+    int _width; ///< Number of columns.
+    int _height; ///< Number of rows.
+    int _wordsPerRow; ///< Number of 64 bit words per row.
+    std::vector<uint64_t> _words; ///< The bits, row major, bit x % 64 of word x / 64 for column x.
+};
+
+#endif /* COLLISIONMASK_H */
@@ -13,6 +13,7 @@
 #include <string>
 
 class Graphics;
+class Camera;
 
 /**
  * @class Enemy
@@ -49,14 +50,16 @@ public:
      * @param p_elapsedTime Time elapsed since the last update.
      * @param p_player Reference to the player object.
      */
-    virtual void update(int p_elapsedTime, Player &p_player);
+    virtual void update(float p_elapsedTime, Player &p_player);
 
     /**
      * @brief Draws the enemy on the screen.
      * 
      * @param p_graphics Graphics context to draw the enemy.
+     * @param p_camera Camera converting the enemy's world position to the screen.
+     * @param p_alpha How far the frame is between the previous and the current tick, from 0 to 1.
      */
-    virtual void draw(Graphics &p_graphics);
+    virtual void draw(Graphics &p_graphics, const Camera &p_camera, float p_alpha);
 
     /**
      * @brief Handles the interaction when the enemy touches the player.
@@ -118,14 +121,16 @@ public:
      * @param p_elapsedTime Time elapsed since the last update.
      * @param p_player Reference to the player object.
      */
-    void update(int p_elapsedTime, Player &p_player);
+    void update(float p_elapsedTime, Player &p_player);
 
     /**
      * @brief Draws the bat on the screen.
      * 
      * @param p_graphics Graphics context to draw the bat.
+     * @param p_camera Camera converting the bat's world position to the screen.
+     * @param p_alpha How far the frame is between the previous and the current tick, from 0 to 1.
      */
-    void draw(Graphics &p_graphics);
+    void draw(Graphics &p_graphics, const Camera &p_camera, float p_alpha);
 
     /**
      * @brief Handles the interaction when the bat touches the player.
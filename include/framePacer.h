@@ -0,0 +1,102 @@
+/**
+ * @file framePacer.h
+ * @brief Defines the FramePacer class, which controls how fast the game loop presents frames.
+ */
+
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+#include <SDL2/SDL.h>
+
+/**
+ * @namespace pacing
+ * @brief Ways the game loop can be paced.
+ */
+namespace pacing{
+    enum Mode{
+        VSYNC, ///< Present blocks until the display refresh, no extra waiting.
+        LIMITED, ///< Sleep until the next frame deadline for a target frame rate.
+        UNCAPPED, ///< Run as fast as possible, for benchmarks.
+    };
+}
+
+/**
+ * @class FramePacer
+ * @brief Waits out the rest of each frame and measures the frame times actually achieved.
+ * 
+ * In LIMITED mode the pacer sleeps in 1 ms SDL_Delay steps until less than a millisecond is left
+ * and then yields until the deadline, which keeps the CPU mostly idle while staying accurate to a
+ * fraction of a millisecond. Frame times are kept over a sliding window to report their
+ * average and jitter (standard deviation).
+ */
+class FramePacer {
+public:
+    /**
+     * @brief Default constructor. Creates an uncapped pacer.
+     */
+    FramePacer();
+
+    /**
+     * @brief Constructs a pacer for a mode and target frame rate.
+     * 
+     * @param p_mode The pacing mode.
+     * @param p_targetFps Frames per second aimed at in LIMITED mode.
+     */
+    FramePacer(pacing::Mode p_mode, int p_targetFps);
+
+    /**
+     * @brief Ends the current frame: waits until its deadline if limited, then records its duration.
+     */
+    void endFrame();
+
+    /**
+     * @brief Gets the pacing mode.
+     * 
+     * @return pacing::Mode: The mode.
+     */
+    inline pacing::Mode getMode() const { return this->_mode; }
+
+    /**
+     * @brief Gets the duration of the last frame.
+     * 
+     * @return float: The frame time in milliseconds.
+     */
+    inline float getLastFrameTime() const { return this->_lastFrameTime; }
+
+    /**
+     * @brief Gets the average frame time over the recent frames.
+     * 
+     * @return float: The average frame time in milliseconds.
+     */
+    float getAverageFrameTime() const;
+
+    /**
+     * @brief Gets the standard deviation of the frame time over the recent frames.
+     * 
+     * @return float: The jitter in milliseconds.
+     */
+    float getJitter() const;
+
+    /**
+     * @brief Gets a short name for a pacing mode, for logs.
+     * 
+     * @param p_mode The pacing mode.
+     * @return const char*: The name of the mode.
+     */
+    static const char* getModeName(pacing::Mode p_mode);
+
+private:
+    static const int WINDOW_SIZE = 120; ///< Number of frames the statistics are computed over.
+
+    pacing::Mode _mode; ///< The pacing mode.
+    Uint64 _frequency; ///< Performance counter ticks per second.
+    Uint64 _frameDuration; ///< Target frame duration in counter ticks (LIMITED only).
+    Uint64 _deadline; ///< Counter value at which the current frame should end.
+    Uint64 _lastFrameEnd; ///< Counter value at the end of the previous frame.
+
+    float _lastFrameTime; ///< Duration of the last frame, in milliseconds.
+    float _frameTimes[WINDOW_SIZE]; ///< Recent frame times, used as a ring buffer.
+    int _frameCount; ///< Number of frames recorded so far.
+};
+
+#endif /* FRAMEPACER_H */
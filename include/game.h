@@ -11,8 +11,50 @@
 
 #include "player.h"
 #include "level.h"
+#include "levelCache.h"
+#include "levelPreloader.h"
 #include "hud.h"
 #include "graphics.h"
+#include "camera.h"
+#include "framePacer.h"
+#include "input.h"
+#include "inputRecording.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * @struct GameOptions
+ * @brief Settings chosen on the command line when the game starts.
+ */
+struct GameOptions {
+    int TickRate; ///< Simulation updates per second, independent of the frame rate.
+    pacing::Mode Pacing; ///< How the frame rate is limited.
+    int TargetFps; ///< Frame rate aimed at by pacing::LIMITED, and by vsync when it's unavailable.
+    int StreamRadius; ///< Screens of chunks kept loaded around the player in infinite maps, 0 to load them whole.
+    tiledraw::Mode TileDrawMode; ///< How the levels draw their tile layers.
+    bool Headless; ///< Run the simulation without a display, drawing nothing and as fast as possible.
+    unsigned long long Ticks; ///< Ticks to simulate before quitting, 0 to run until the game is closed.
+    std::string RecordPath; ///< File the input of every tick is saved to when the game quits, empty to not record.
+    std::string ReplayPath; ///< Recording whose input is played back instead of the keyboard's, empty to play live.
+    std::string StartMap; ///< Name of the map the game starts in.
+    bool PerfOverlay; ///< Start with the HUD's performance overlay shown, F3 toggles it.
+
+    /**
+     * @brief Default constructor. Sets the default options.
+     */
+    GameOptions() :
+        TickRate(120),
+        Pacing(pacing::VSYNC),
+        TargetFps(60),
+        StreamRadius(0),
+        TileDrawMode(tiledraw::BATCHED),
+        Headless(false),
+        Ticks(0),
+        StartMap("Map 1"),
+        PerfOverlay(false)
+    {}
+};
 
 /**
  * @class Game
@@ -24,41 +66,149 @@
 class Game{
 public:
     /**
-     * @brief Constructs the Game object and initializes game state.
+     * @brief Constructs the Game object and runs it until it's closed or its tick count is reached.
+     *
+     * With GameOptions::Headless, SDL uses its dummy video driver so no display is needed, and the
+     * simulation runs through simulate() instead of the interactive game loop.
+     * 
+     * @param p_options Settings for this run of the game.
      */
-    Game();
+    Game(const GameOptions &p_options = GameOptions());
 
     /**
      * @brief Destructs the Game object, performing necessary cleanup.
      */
     ~Game();
 
+    /**
+     * @brief Gets the number of ticks simulated so far.
+     *
+     * @return unsigned long long: The tick count, final once the constructor returns.
+     */
+    inline unsigned long long getTicks() const { return this->_ticks; }
+
+    /**
+     * @brief Tells whether the run failed, because its replay couldn't be loaded or its recording saved.
+     *
+     * @return bool: True if the run failed, final once the constructor returns.
+     */
+    inline bool hasFailed() const { return this->_failed; }
+
+    /**
+     * @brief Gets the player, to inspect where a run ended.
+     *
+     * @return const Player&: The player.
+     */
+    inline const Player& getPlayer() const { return this->_player; }
+
+    /**
+     * @brief Gets the level the player is in.
+     *
+     * @return const Level&: The current level.
+     */
+    inline const Level& getLevel() const { return this->_level; }
+
 private:
     /**
      * @brief Contains the game's main loop logic.
      *
-     * Calls update and draw methods in a loop until the game ends.
+     * The simulation advances in fixed ticks of _tickDuration, as many per frame as the real time
+     * elapsed requires. Rendering happens once per frame and interpolates between the last two ticks,
+     * so movement is deterministic whatever the frame rate is.
      */
     void gameLoop();
 
+    /**
+     * @brief Runs the simulation without a display.
+     *
+     * Steps GameOptions::Ticks fixed ticks back to back, without drawing or waiting on real time,
+     * so a session takes only as long as its updates. Doors are loaded on demand rather than
+     * preloaded, which keeps runs deterministic.
+     */
+    void simulate();
+
+    /**
+     * @brief Loads the first level and creates the player and the HUD.
+     *
+     * @param p_graphics Graphics the sprites and tiles are loaded with.
+     */
+    void start(Graphics &p_graphics);
+
+    /**
+     * @brief Runs one simulation tick with the keyboard state gathered since the previous one.
+     *
+     * The tick's input is recorded, or replaced by the recorded one when replaying, then the
+     * key events are cleared so the next tick only sees the ones that happen after this one.
+     *
+     * @param p_input Keyboard state gathered from the events since the previous tick.
+     * @param p_graphics Graphics new levels are loaded with.
+     */
+    void tick(Input &p_input, Graphics &p_graphics);
+
+    /**
+     * @brief Turns the keys pressed into player actions.
+     *
+     * @param p_input Keyboard state of the current frame.
+     */
+    void handleInput(const Input &p_input);
+
     /**
      * @brief Draws the game's current state to the screen.
      *
      * @param p_graphics Reference to the Graphics object for rendering.
+     * @param p_alpha How far the frame is between the previous and the current tick, from 0 to 1.
      */
-    void draw(Graphics &p_graphics);
+    void draw(Graphics &p_graphics, float p_alpha);
 
     /**
      * @brief Updates the game's state.
      *
-     * @param p_elapsedTime The time elapsed since the last update call.
+     * @param p_elapsedTime The duration of a tick, in milliseconds.
+     * @param p_graphics Graphics new levels are loaded with.
      */
     void update(float p_elapsedTime, Graphics &p_graphics);
 
+    /**
+     * @brief Checks if the run reached its tick count.
+     *
+     * @return bool: True once GameOptions::Ticks ticks were simulated, or once the replayed recording ends.
+     */
+    inline bool isFinished() const {
+        return (this->_options.Ticks > 0 && this->_ticks >= this->_options.Ticks) ||
+            (!this->_options.ReplayPath.empty() && this->_recording.isFinished());
+    }
+
+    /**
+     * @brief Queues the destinations of the current level's doors for background loading.
+     */
+    void preloadDoorDestinations();
+
     Player _player; ///< Represents the player character in the game.
     Level _level; ///< Represents the current level in the game.
+    LevelCache _levelCache; ///< Loaded maps, so re-entering a level doesn't read its map again.
+    LevelPreloader _levelPreloader; ///< Loads the maps behind the current level's doors in the background.
+    std::string _preloadedMap; ///< Map whose door destinations were last queued for preloading.
     Hud _hud; ///< Represents the heads-up display (HUD) in the game.
-    Graphics _graphics; ///< Graphics object used for rendering.
+    Camera _camera; ///< Camera following the player.
+
+    // Reusable collision buffers, kept across frames so the collision pass doesn't allocate
+    std::vector<Rectangle> _tileHits; ///< Tiles the player collided with this tick.
+    std::vector<Object> _objectHits; ///< Objects the player collided with this tick.
+    std::vector<Slope> _slopeHits; ///< Slopes the player collided with this tick.
+    std::vector<Door> _doorHits; ///< Doors the player collided with this tick.
+    std::vector<Enemy*> _enemyHits; ///< Enemies the player collided with this tick.
+
+    InputRecording _recording; ///< Input recorded during this run, or played back by it.
+    Input _replayInput; ///< Keyboard state the replayed ticks run with.
+
+    GameOptions _options; ///< Settings for this run of the game.
+    float _tickDuration; ///< Duration of a simulation tick, in milliseconds.
+    float _renderTime; ///< Time the last draw() took before presenting, in milliseconds.
+
+    unsigned long long _collisionAllocations; ///< Heap allocations made by the collision pass in the last tick.
+    unsigned long long _totalCollisionAllocations; ///< Heap allocations made by the collision pass since start.
+    unsigned long long _ticks; ///< Number of updates run so far.
+    bool _failed; ///< Whether the replay couldn't be loaded or the recording couldn't be saved.
 };
 
 #endif // GAME_H
\ No newline at end of file
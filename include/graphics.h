@@ -7,6 +7,7 @@
  */
 
 #include <map>
+#include <memory>
 #include <string>
 
 struct SDL_Window;
@@ -14,6 +15,8 @@ struct SDL_Renderer;
 struct SDL_Surface;
 struct SDL_Rect;
 struct SDL_Texture;
+struct SDL_Vertex;
+struct SDL_Color;
 
 /**
  * @class Graphics
@@ -28,8 +31,12 @@ public:
      * @brief Constructor that initializes the window and the renderer.
      * 
      * Sets the window title to "Cavestory".
+     * 
+     * @param p_vsync True to make flip() wait for the display refresh.
+     * @param p_headless True to render in memory with the software renderer and keep the window hidden,
+     *                   for runs without a display. SDL must then be initialized with the dummy video driver.
      */
-    Graphics();
+    Graphics(bool p_vsync = false, bool p_headless = false);
 
     /**
      * @brief Destructor that cleans up resources.
@@ -49,6 +56,58 @@ public:
      */
     SDL_Surface* loadImage(const std::string &p_filePath);
 
+    /**
+     * @brief Gets the texture for an image, uploading it to the GPU the first time it is requested.
+     * 
+     * Textures are cached by path and shared: every caller asking for the same image gets the same
+     * texture, and the texture is destroyed once the last shared_ptr to it goes away. The surface
+     * the texture was made from is freed right after the upload.
+     * 
+     * @param p_filePath The file path of the image to load.
+     * @return std::shared_ptr<SDL_Texture> The shared texture, empty if the image could not be loaded.
+     */
+    std::shared_ptr<SDL_Texture> loadTexture(const std::string &p_filePath);
+
+    /**
+     * @brief Uploads an image decoded elsewhere (e.g. on a loading thread) into the texture cache.
+     * 
+     * Takes ownership of the surface and frees it. If the image already has a live texture,
+     * that texture is returned and nothing is uploaded.
+     * 
+     * @param p_filePath The file path the image was loaded from, used as its cache key.
+     * @param p_surface The decoded image. May be NULL.
+     * @return std::shared_ptr<SDL_Texture> The shared texture, empty if there was nothing to upload.
+     */
+    std::shared_ptr<SDL_Texture> uploadTexture(const std::string &p_filePath, SDL_Surface* p_surface);
+
+    /**
+     * @brief Creates a transparent texture that can be rendered into.
+     * 
+     * @param p_width Width of the texture.
+     * @param p_height Height of the texture.
+     * @return std::shared_ptr<SDL_Texture> The texture, empty if it could not be created.
+     */
+    std::shared_ptr<SDL_Texture> createTargetTexture(int p_width, int p_height);
+
+    /**
+     * @brief Checks whether the renderer can draw into textures.
+     * 
+     * @return bool True if render targets are supported.
+     */
+    bool supportsRenderTargets() const;
+
+    /**
+     * @brief Redirects drawing into a target texture and clears it to transparent.
+     * 
+     * @param p_texture A texture made by createTargetTexture().
+     */
+    void beginRenderToTexture(SDL_Texture* p_texture);
+
+    /**
+     * @brief Sends drawing back to the screen after beginRenderToTexture().
+     */
+    void endRenderToTexture();
+
     /**
      * @brief Draws a given texture onto a part of the screen.
      * 
@@ -59,7 +118,28 @@ public:
     void blitSurface(SDL_Texture* p_texture, SDL_Rect* p_src, SDL_Rect* p_dst);
 
     /**
-     * @brief Renders everything on the screen.
+     * @brief Draws textured triangles in a single call.
+     * 
+     * @param p_texture The texture sampled by the triangles.
+     * @param p_vertices The vertices of the triangles.
+     * @param p_vertexCount The number of vertices.
+     * @param p_indices Three indices into p_vertices per triangle.
+     * @param p_indexCount The number of indices.
+     */
+    void renderGeometry(SDL_Texture* p_texture, const SDL_Vertex* p_vertices, int p_vertexCount,
+                        const int* p_indices, int p_indexCount);
+
+    /**
+     * @brief Fills rectangles with a color in a single call, blending it when it isn't opaque.
+     * 
+     * @param p_rects The rectangles, in screen pixels.
+     * @param p_count The number of rectangles.
+     * @param p_color The fill color.
+     */
+    void fillRects(const SDL_Rect* p_rects, int p_count, const SDL_Color &p_color);
+
+    /**
+     * @brief Renders everything on the screen, and closes the frame's draw statistics.
      */
     void flip();
 
@@ -75,9 +155,61 @@ public:
      */
     SDL_Renderer* getRenderer() const;
 
+    /**
+     * @brief Checks whether the renderer actually synchronizes presents with the display.
+     * 
+     * @return bool True if vsync is active.
+     */
+    bool isVsyncEnabled() const;
+
+    /**
+     * @brief Checks whether the graphics were created for a run without a display.
+     * 
+     * @return bool True if the window is hidden and rendering happens in memory.
+     */
+    inline bool isHeadless() const { return this->_headless; }
+
+    /**
+     * @brief Gets the number of draw calls of the last frame shown, render to texture included.
+     * 
+     * @return int: The draw call count.
+     */
+    inline int getDrawCalls() const { return this->_frameDrawCalls; }
+
+    /**
+     * @brief Gets the number of times the last frame shown switched to another texture between draw calls.
+     * 
+     * @return int: The texture bind count.
+     */
+    inline int getTextureBinds() const { return this->_frameTextureBinds; }
+
 private:
+    /**
+     * @brief Wraps a texture in a shared_ptr that destroys it while the renderer is still alive.
+     * 
+     * @param p_texture The texture to wrap.
+     * @return std::shared_ptr<SDL_Texture> The owning pointer.
+     */
+    std::shared_ptr<SDL_Texture> makeSharedTexture(SDL_Texture* p_texture);
+
+    /**
+     * @brief Counts a draw call, and a texture bind if it samples another texture than the previous one.
+     * 
+     * @param p_texture The texture drawn with, NULL for untextured draws.
+     */
+    void countDrawCall(SDL_Texture* p_texture);
+
     SDL_Window* _window; ///< The main window.
     SDL_Renderer* _renderer; ///< The renderer for drawing.
-    std::map<std::string, SDL_Surface*> _spriteSheets; ///< Map of sprite sheets loaded.
+    std::map<std::string, SDL_Surface*> _spriteSheets; ///< Map of sprite sheets loaded but not uploaded yet.
+    std::map<std::string, std::weak_ptr<SDL_Texture>> _textures; ///< Map of textures uploaded, by file path.
+    std::shared_ptr<bool> _rendererAlive; ///< Cleared when the renderer is destroyed, so late texture releases don't touch it.
+    bool _headless; ///< True if nothing is ever shown on screen.
+
+    SDL_Texture* _boundTexture; ///< Texture of the last textured draw call of the current frame.
+    int _drawCalls; ///< Draw calls of the current frame.
+    int _textureBinds; ///< Texture switches of the current frame.
+    int _frameDrawCalls; ///< Draw calls of the last frame shown.
+    int _frameTextureBinds; ///< Texture switches of the last frame shown.
 };
 #endif /* GRAPHICS_H */
\ No newline at end of file
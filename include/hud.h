@@ -11,6 +11,20 @@
 
 class Graphics;
 
+/**
+ * @struct PerfStats
+ * @brief Measurements of a frame, shown by the HUD's performance overlay.
+ */
+struct PerfStats {
+    float FrameTime; ///< Real time between the last two frames, in milliseconds.
+    float UpdateTime; ///< Time spent running the frame's ticks, in milliseconds.
+    float RenderTime; ///< Time spent drawing the previous frame, without waiting on the display, in milliseconds.
+    int DrawCalls; ///< Draw calls of the previous frame.
+    int TextureBinds; ///< Texture switches between the previous frame's draw calls.
+    int CollisionTests; ///< Narrow phase collision tests run by the frame's ticks.
+    int Entities; ///< The player and the level's enemies.
+};
+
 /**
  * @class Hud
  * @brief Represents the Heads-Up Display (HUD) in the game.
@@ -39,7 +53,7 @@ public:
      * @param p_elapsedTime Time elapsed since the last update.
      * @param p_player Reference to the player object.
      */
-    void update(int p_elapsedTime, Player &p_player);
+    void update(float p_elapsedTime, Player &p_player);
 
     /**
      * @brief Draws the HUD on the screen.
@@ -48,7 +62,52 @@ public:
      */
     void draw(Graphics &p_graphics);
 
+    /**
+     * @brief Records a frame's measurements for the performance overlay, and adds its frame time to the graph.
+     * 
+     * @param p_stats Measurements of the frame.
+     */
+    void setPerfStats(const PerfStats &p_stats);
+
+    /**
+     * @brief Shows or hides the performance overlay.
+     * 
+     * @param p_visible True to draw the overlay with the HUD.
+     */
+    inline void setPerfOverlayVisible(bool p_visible) { this->_perfOverlayVisible = p_visible; }
+
+    /**
+     * @brief Checks if the performance overlay is drawn.
+     * 
+     * @return bool: True if the overlay is visible.
+     */
+    inline bool isPerfOverlayVisible() const { return this->_perfOverlayVisible; }
+
+    static const int PERF_GRAPH_FRAMES = 120; ///< Frames shown by the frame time graph.
+
 private:
+    /**
+     * @brief Draws the performance overlay in the top right corner.
+     * 
+     * One row per value, each marked by a colored swatch: FPS (white), frame time (green, over its
+     * graph), update time (blue), render time (orange), draw calls (purple), texture binds (cyan),
+     * collision tests (red) and entities (yellow). Times are in milliseconds with two decimals.
+     * 
+     * @param p_graphics Graphics context to draw the overlay.
+     */
+    void drawPerfOverlay(Graphics &p_graphics);
+
+    /**
+     * @brief Draws a number with the HUD's digit glyphs.
+     * 
+     * @param p_graphics Graphics context to draw the number.
+     * @param p_value The number, negative values are drawn as 0.
+     * @param p_decimals Digits drawn after the decimal point.
+     * @param p_x Left of the first digit on the screen.
+     * @param p_y Top of the digits on the screen.
+     */
+    void drawNumber(Graphics &p_graphics, float p_value, int p_decimals, int p_x, int p_y);
+
     Player _player; ///< Reference to the player object.
 
     // Health sprites
@@ -64,6 +123,14 @@ private:
     // Weapon info sprites
     Sprite _slash; ///< Sprite for the slash weapon.
     Sprite _dashes; ///< Sprite for the dashes weapon.
+
+    // Performance overlay, drawn from fixed storage so it doesn't allocate per frame
+    bool _perfOverlayVisible; ///< True if the performance overlay is drawn.
+    Sprite _perfDigit; ///< Digit glyph, its source moved to the digit drawn.
+    PerfStats _perfStats; ///< Measurements of the last frame.
+    float _frameTimes[PERF_GRAPH_FRAMES]; ///< Ring of the last frame times, in milliseconds.
+    int _frameTimeIndex; ///< Slot of _frameTimes the next frame time is written to.
+    SDL_Rect _graphBars[PERF_GRAPH_FRAMES]; ///< Bars of the frame time graph, rebuilt when drawn.
 };
 
 #endif /* HUD */
\ No newline at end of file
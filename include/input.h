@@ -2,7 +2,7 @@
 #define INPUT_H
 
 #include <SDL2/SDL.h>
-#include <map>
+#include <bitset>
 
 /**
  * @class Input
@@ -17,13 +17,14 @@ public:
      * @brief Called at the beginning of each new frame to reset the keys' states.
      * 
      * Clears the states of _pressedKeys and _releasedKeys to prepare for the next frame's input.
+     * Both are fixed-size bitsets, so this never allocates.
      */
     void beginNewFrame();
     
     /**
      * @brief Handles the event when a key is released.
      * 
-     * Updates the _heldKeys and _releasedKeys maps based on the key release event.
+     * Updates the _heldKeys and _releasedKeys bits based on the key release event.
      * 
      * @param e The SDL_Event containing the key release information.
      */
@@ -32,7 +33,7 @@ public:
     /**
      * @brief Handles the event when a key is pressed.
      * 
-     * Updates the _heldKeys and _pressedKeys maps based on the key press event.
+     * Updates the _heldKeys and _pressedKeys bits based on the key press event.
      * 
      * @param e The SDL_Event containing the key press information.
      */
@@ -44,7 +45,7 @@ public:
      * @param p_key The SDL_Scancode representing the key to check.
      * @return bool True if the key was pressed, false otherwise.
      */
-    bool wasKeyPressed(SDL_Scancode p_key);
+    bool wasKeyPressed(SDL_Scancode p_key) const;
     
     /**
      * @brief Checks if a specific key was released during the current frame.
@@ -52,7 +53,7 @@ public:
      * @param p_key The SDL_Scancode representing the key to check.
      * @return bool True if the key was released, false otherwise.
      */
-    bool wasKeyReleased(SDL_Scancode p_key);
+    bool wasKeyReleased(SDL_Scancode p_key) const;
     
     /**
      * @brief Checks if a specific key is being held down.
@@ -60,12 +61,31 @@ public:
      * @param p_key The SDL_Scancode representing the key to check.
      * @return bool True if the key is held, false otherwise.
      */
-    bool isKeyHeld(SDL_Scancode p_key);
+    bool isKeyHeld(SDL_Scancode p_key) const;
+
+    /**
+     * @brief Checks if any key was pressed or released during the current frame.
+     * 
+     * @return bool True if at least one key changed, false if the keys are as they were.
+     */
+    bool hasKeyEvents() const;
+
+    /**
+     * @brief Sets the whole state of a key, as if it had been reached through key events.
+     * 
+     * Used to replay recorded input. Invalid scancodes are ignored.
+     * 
+     * @param p_key The SDL_Scancode of the key.
+     * @param p_pressed True if the key was pressed during the current frame.
+     * @param p_released True if the key was released during the current frame.
+     * @param p_held True if the key is held down.
+     */
+    void setKeyState(SDL_Scancode p_key, bool p_pressed, bool p_released, bool p_held);
 
 private:
-    std::map<SDL_Scancode, bool> _heldKeys; ///< Tracks keys that are currently held down.
-    std::map<SDL_Scancode, bool> _pressedKeys; ///< Tracks keys that were pressed during the current frame.
-    std::map<SDL_Scancode, bool> _releasedKeys; ///< Tracks keys that were released during the current frame.
+    std::bitset<SDL_NUM_SCANCODES> _heldKeys; ///< One bit per scancode, set while the key is held down.
+    std::bitset<SDL_NUM_SCANCODES> _pressedKeys; ///< One bit per scancode, set if the key was pressed during the current frame.
+    std::bitset<SDL_NUM_SCANCODES> _releasedKeys; ///< One bit per scancode, set if the key was released during the current frame.
 };
 
 #endif // INPUT_H
\ No newline at end of file
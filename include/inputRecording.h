@@ -0,0 +1,114 @@
+/**
+ * @file inputRecording.h
+ * @brief Defines the InputRecording class, which records the keyboard state of every tick and plays it back.
+ */
+
+#ifndef INPUTRECORDING_H
+#define INPUTRECORDING_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "input.h"
+
+/**
+ * @class InputRecording
+ * @brief Keyboard input of a run, one state per simulation tick.
+ *
+ * Only the keys pressed or released during a tick are stored, along with whether they are still
+ * held after it. Keys held across ticks carry over, so a tick where nothing changes costs nothing.
+ * Played back at the tick rate it was recorded at, a recording reproduces the run tick for tick.
+ *
+ * On disk, a recording is the magic "CSIR", then the version, the tick rate, the tick count and
+ * the change count as little endian 32 bit integers. Each change follows as a varint of the ticks
+ * since the previous change, then 16 bits holding the scancode and the key's flags.
+ */
+class InputRecording {
+public:
+    /**
+     * @brief Default constructor. Creates an empty recording.
+     */
+    InputRecording();
+
+    /**
+     * @brief Records the keyboard state of the next tick.
+     *
+     * @param p_input Keyboard state the tick runs with.
+     */
+    void record(const Input &p_input);
+
+    /**
+     * @brief Plays back the next tick.
+     *
+     * The edges of the previous tick are cleared and the keys that changed during this tick are set.
+     *
+     * @param p_input Keyboard state to update, which must only be changed by this recording.
+     * @return bool: True if a tick was played, false once every recorded tick was.
+     */
+    bool replay(Input &p_input);
+
+    /**
+     * @brief Checks if every recorded tick was played back.
+     *
+     * @return bool: True if replay() has no tick left.
+     */
+    inline bool isFinished() const { return this->_replayedTicks >= this->_tickCount; }
+
+    /**
+     * @brief Saves the recording to a file.
+     *
+     * @param p_filePath The file to write.
+     * @return bool: True if the file was written.
+     */
+    bool save(const std::string &p_filePath) const;
+
+    /**
+     * @brief Replaces this recording by one saved to a file, ready to be played from its first tick.
+     *
+     * @param p_filePath The file to read.
+     * @return bool: True if the file was read, false if it is missing or isn't a valid recording.
+     */
+    bool load(const std::string &p_filePath);
+
+    /**
+     * @brief Gets the tick rate the recording was made at.
+     *
+     * @return int: Ticks per second.
+     */
+    inline int getTickRate() const { return this->_tickRate; }
+
+    /**
+     * @brief Sets the tick rate the recording is made at.
+     *
+     * @param p_tickRate Ticks per second.
+     */
+    inline void setTickRate(int p_tickRate) { this->_tickRate = p_tickRate; }
+
+    /**
+     * @brief Gets the number of recorded ticks.
+     *
+     * @return uint32_t: The tick count.
+     */
+    inline uint32_t getTickCount() const { return this->_tickCount; }
+
+private:
+    /**
+     * @struct KeyChange
+     * @brief A key pressed or released during a tick.
+     */
+    struct KeyChange {
+        uint32_t Tick; ///< Tick the change happened during.
+        uint16_t Key; ///< The scancode in the low 9 bits, then the pressed, released and held flags.
+    };
+
+    std::vector<KeyChange> _changes; ///< Every change, in tick order.
+    uint32_t _tickCount; ///< Number of recorded ticks.
+    int _tickRate; ///< Ticks per second the recording was made at.
+
+    uint32_t _replayedTicks; ///< Number of ticks played back so far.
+    size_t _nextChange; ///< Index of the first change not played back yet.
+    std::vector<uint16_t> _replayedKeys; ///< Keys changed by the tick played last, whose edges are cleared on the next one.
+};
+
+#endif /* INPUTRECORDING_H */
@@ -16,14 +16,52 @@
 #include "animatedTile.h"
 #include "door.h"
 #include "object.h"
+#include "spatialGrid.h"
+#include "tileBatch.h"
+#include "tileGrid.h"
+#include "collisionMask.h"
+#include "tileChunkCache.h"
+#include "camera.h"
 
 class Graphics;
+class ChunkStreamer;
 class Enemy;
 class Player;
+class MapData;
+struct LevelTemplate;
 struct SDL_Texture;
 struct SDL_Rect;
 struct Tileset;
 
+/**
+ * @namespace tiledraw
+ * @brief Ways a level can draw its tile layers.
+ */
+namespace tiledraw{
+    enum Mode{
+        PER_TILE, ///< One blit per tile.
+        BATCHED, ///< One geometry call per layer and tileset.
+        CACHED, ///< Static tiles pre-rendered into chunk textures, animated tiles batched on top.
+    };
+}
+
+/**
+ * @struct TileLayerRange
+ * @brief The animated tiles of one map layer inside a level's animated tile list.
+ * 
+ * A layer's tiles are stored contiguously in map order (row by row, left to right), so the
+ * tiles of a row are a sub-range found through RowStarts and sorted by x.
+ */
+struct TileLayerRange {
+    int Begin; ///< Index of the layer's first tile.
+    int End; ///< Index one past the layer's last tile.
+    std::vector<int> RowStarts; ///< Index of the first tile of each row, plus End.
+    int FirstBatch; ///< Index of the layer's first batch in the level's tile batches.
+    int BatchCount; ///< Number of batches (one per tileset) used by the layer.
+};
+
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector> 
 
@@ -43,71 +81,140 @@ public:
     Level();
 
     /**
-     * @brief Constructs a Level with a map name, spawn point, and graphics context.
+     * @brief Constructs a Level from a loaded map, usually obtained from a LevelCache.
+     * 
+     * Only the level's runtime state is built: no file is read and no tileset texture is loaded.
+     * The tiles of an infinite map are either all built here, or streamed around the player
+     * by a ChunkStreamer when a streaming radius is given.
      * 
-     * @param p_mapName Name of the map file to load.
-     * @param p_graphics Graphics context for rendering the level.
+     * @param p_template The map and tileset textures of the level.
+     * @param p_graphics Graphics context used by the level's enemies.
+     * @param p_streamingRadius Screens of chunks kept loaded around the player in an infinite map, 0 to load it whole.
      */
-    Level(std::string p_mapName, Graphics &p_graphics);
+    Level(const std::shared_ptr<const LevelTemplate> &p_template, Graphics &p_graphics, int p_streamingRadius = 0);
 
     /**
      * @brief Destructor. Cleans up resources used by the level.
      */
     ~Level();
 
+    /**
+     * @brief Levels own their enemies, so they can be moved but not copied.
+     */
+    Level(Level &&p_other);
+    Level &operator=(Level &&p_other);
+    Level(const Level&) = delete;
+    Level &operator=(const Level&) = delete;
+
     /**
      * @brief Updates the level state.
      * 
      * @param p_elapsedTime Time elapsed since the last update call.
+     * @param p_player The player, which enemies react to.
      */
-    void update(int p_elapsedTime, Player &p_player, Graphics &p_graphics);
+    void update(float p_elapsedTime, Player &p_player);
 
     /**
-     * @brief Draws the level to the screen.
+     * @brief Draws the part of the level visible through the camera.
+     * 
+     * Only the tile rows and columns inside the view (plus a one tile margin) are visited,
+     * so the cost depends on the screen size rather than the map size.
      * 
      * @param p_graphics Graphics context used for rendering.
+     * @param p_camera Camera selecting the visible part of the level.
+     * @param p_alpha How far the frame is between the previous and the current tick, from 0 to 1.
+     */
+    void draw(Graphics &p_graphics, const Camera &p_camera, float p_alpha);
+
+    /**
+     * @brief Chooses how the tile layers are drawn.
+     * 
+     * Batched drawing is the default. The cached mode falls back to batched drawing
+     * when the renderer does not support render targets.
+     * 
+     * @param p_mode The draw mode.
+     */
+    inline void setTileDrawMode(tiledraw::Mode p_mode) { this->_tileDrawMode = p_mode; }
+
+    /**
+     * @brief Marks an area whose tiles changed, so cached chunks covering it are re-rendered.
+     * 
+     * @param p_area The changed area, in world pixels.
+     */
+    void invalidateTiles(const Rectangle &p_area);
+
+    /**
+     * @brief Marks every cached chunk for re-rendering, e.g. after the renderer lost its targets.
+     */
+    void invalidateTileCache();
+
+    /**
+     * @brief Gets the gid of the tile in a cell, static or animated, in O(1).
+     * 
+     * @param p_layer Index of the map layer.
+     * @param p_x Column of the cell.
+     * @param p_y Row of the cell.
+     * @return uint32_t: The gid, 0 for an empty cell or a cell outside the level.
+     */
+    uint32_t getTile(int p_layer, int p_x, int p_y) const;
+
+    /**
+     * @brief Replaces the tile in a cell, and re-renders the cached chunks covering it.
+     * 
+     * Animated gids are played like the map's own animated tiles, and replacing an animated tile
+     * removes its animation. The cell's solidity follows the new tile, and setting a cell of the
+     * collision layer makes it solid.
+     * 
+     * @param p_layer Index of the map layer.
+     * @param p_x Column of the cell.
+     * @param p_y Row of the cell.
+     * @param p_gid The new gid, 0 to remove the tile.
      */
-    void draw(Graphics &p_graphics);
+    void setTile(int p_layer, int p_x, int p_y, uint32_t p_gid);
 
     /**
      * @brief Checks for collisions with tiles.
      * 
+     * Covers the map's collision rectangles and, when the map has solid tiles or a collision layer,
+     * the solid cells under the rectangle. The buffer is cleared and refilled, so a caller reusing the
+     * same vector every frame does not allocate once its capacity has grown to the largest hit count.
+     * 
      * @param p_other The rectangle to check for collisions.
-     * @return std::vector<Rectangle> A vector of rectangles representing the colliding tiles.
+     * @param p_others Filled with the rectangles of the colliding tiles.
      */
-    std::vector<Rectangle> checkTileCollisions(const Rectangle &p_other);
+    void checkTileCollisions(const Rectangle &p_other, std::vector<Rectangle> &p_others);
 
     /**
      * @brief Checks for collisions with objects.
      * 
      * @param p_other The rectangle to check for collisions.
-     * @return std::vector<Object> A vector of objects representing the colliding objects.
+     * @param p_others Filled with the colliding objects.
      */
-    std::vector<Object> checkObjectCollisions(const Rectangle &p_other);
+    void checkObjectCollisions(const Rectangle &p_other, std::vector<Object> &p_others);
 
     /**
      * @brief Checks for collisions with slopes.
      * 
      * @param p_other The rectangle to check for collisions.
-     * @return std::vector<Slope> A vector of slopes representing the colliding slopes.
+     * @param p_others Filled with the colliding slopes.
      */
-    std::vector<Slope> checkSlopeCollisions(const Rectangle &p_other);
+    void checkSlopeCollisions(const Rectangle &p_other, std::vector<Slope> &p_others);
 
     /**
      * @brief Checks for collisions with doors.
      * 
      * @param p_other The rectangle to check for collisions.
-     * @return std::vector<Door> A vector of doors representing the colliding doors.
+     * @param p_others Filled with the colliding doors.
      */
-    std::vector<Door> checkDoorCollisions(const Rectangle &p_other);
+    void checkDoorCollisions(const Rectangle &p_other, std::vector<Door> &p_others);
 
     /**
      * @brief Checks for collisions with enemies.
      * 
      * @param p_other The rectangle to check for collisions.
-     * @return std::vector<Enemy*> A vector of pointers to enemies representing the colliding enemies.
+     * @param p_others Filled with pointers to the colliding enemies.
      */
-    std::vector<Enemy*> checkEnemyCollisions(const Rectangle &p_other);
+    void checkEnemyCollisions(const Rectangle &p_other, std::vector<Enemy*> &p_others);
 
     /**
      * @brief Gets the player's spawn point in the level.
@@ -115,6 +222,55 @@ public:
      * @return Vector2f The player's spawn point.
      */
     const Vector2f getPlayerSpawnPoint() const;
+
+    /**
+     * @brief Gets the name of the level's map.
+     * 
+     * @return const std::string& The map name.
+     */
+    inline const std::string &getMapName() const { return this->_mapName; }
+
+    /**
+     * @brief Gets the doors of the level.
+     * 
+     * @return const std::vector<Door>& The doors.
+     */
+    inline const std::vector<Door> &getDoors() const { return this->_doorList; }
+
+    /**
+     * @brief Gets the number of enemies in the level.
+     * 
+     * @return int: The enemy count.
+     */
+    inline int getEnemyCount() const { return this->_enemies.size(); }
+
+    /**
+     * @brief Gets the number of animated tiles in the level.
+     * 
+     * @return int: The animated tile count, 0 for a streamed map.
+     */
+    inline int getAnimatedTileCount() const { return this->_animatedTileList.size(); }
+
+    /**
+     * @brief Gets the number of narrow phase tests the check*Collisions functions ran since the last reset.
+     * 
+     * Only the candidates the broad phase returned are tested, so this shows how well it culls.
+     * 
+     * @return unsigned long long: The test count.
+     */
+    inline unsigned long long getCollisionTests() const { return this->_collisionTests; }
+
+    /**
+     * @brief Sets the collision test count back to 0.
+     */
+    inline void resetCollisionTests() { this->_collisionTests = 0; }
+
+    /**
+     * @brief Gets the size of the level in world pixels.
+     * 
+     * @return Vector2f The level size.
+     */
+    const Vector2f getPixelSize() const;
     
 private:
     std::string _mapName; ///< Name of the map file for the level.
@@ -125,7 +281,8 @@ private:
 
     SDL_Texture* _backgroundTexture; ///< Texture for the level's background.
 
-    std::vector<Tile> _tileList; ///< List of tiles in the level.
+    std::shared_ptr<const LevelTemplate> _template; ///< The map and tileset textures the level was built from.
+    TileGrid _tileGrid; ///< Gids of every cell of each layer. Animated ones are drawn from _animatedTileList instead.
     std::vector<Tileset> _tilesets; ///< List of tilesets used in the level.
     std::vector<Rectangle> _collisionRects; ///< List of rectangles for collision detection.
     std::vector<Slope> _slopes; ///< List of slopes in the level.
@@ -133,27 +290,129 @@ private:
     std::vector<AnimatedTile> _animatedTileList; ///< List of animated tiles in the level.
     std::vector<AnimatedTileInfo> _animatedTileInfo; ///< Information about animated tiles.
     std::vector<Door> _doorList; ///< List of doors in the level.
-    std::vector<Enemy*> _enemies; ///< List of enemies in the level.
+    std::vector<std::unique_ptr<Enemy>> _enemies; ///< List of enemies in the level, owned by it.
     std::vector<Object> _objects; /// < List of various objects in the level.
 
+    std::vector<TileLayerRange> _animatedTileLayers; ///< Layers of _animatedTileList.
+    std::vector<TileBatch> _tileBatches; ///< Visible tile geometry; one per tileset shared by the grid layers, then the animated layers' own.
+    tiledraw::Mode _tileDrawMode; ///< How the tile layers are drawn.
+    TileChunkCache _tileChunkCache; ///< Pre-rendered static tiles, used by tiledraw::CACHED.
+
+    std::unique_ptr<ChunkStreamer> _streamer; ///< Streams the tiles of an infinite map, null when every tile is built.
+
+    SpatialGrid _collisionGrid; ///< Broad phase for _collisionRects.
+    CollisionMask _collisionMask; ///< Solid cells, from solid tiles and the collision layer. Empty if the map has neither.
+    SpatialGrid _slopeGrid; ///< Broad phase for _slopes.
+    SpatialGrid _doorGrid; ///< Broad phase for _doorList.
+    SpatialGrid _enemyGrid; ///< Broad phase for _enemies, updated as they move.
+    std::vector<int> _queryIds; ///< Scratch buffer for broad phase results.
+    unsigned long long _collisionTests; ///< Narrow phase tests run since the last reset.
+
+    /**
+     * @brief Creates the tile batches and indexes the rows of each animated tile layer.
+     * 
+     * The grid layers are drawn one after the other through one batch per tileset, so layers still overlap
+     * in file order. Animated tile layers get their own batches, drawn after every static layer like the per-tile path.
+     */
+    void buildTileLayers();
+
+    /**
+     * @brief Draws the visible cells of every layer of the tile grid.
+     * 
+     * @param p_graphics Graphics context used for rendering.
+     * @param p_camera Camera selecting the visible cells.
+     * @param p_batched True to draw through the tileset batches, false to blit tile by tile.
+     */
+    void drawTileGrid(Graphics &p_graphics, const Camera &p_camera, bool p_batched);
+
+    /**
+     * @brief Draws the visible tiles of some layers.
+     * 
+     * @param p_graphics Graphics context used for rendering.
+     * @param p_camera Camera selecting the visible tiles.
+     * @param p_tiles The tile list the layers index into.
+     * @param p_layers The layers to draw.
+     * @param p_batched True to draw through the layers' batches, false to blit tile by tile.
+     */
+    template <class T>
+    void drawTileLayers(Graphics &p_graphics, const Camera &p_camera, const std::vector<T> &p_tiles,
+                        std::vector<TileLayerRange> &p_layers, bool p_batched);
+
+    /**
+     * @brief Builds the collision grids from the loaded level geometry.
+     * 
+     * The cells are one tile in size, so a query only touches the few tiles its rectangle overlaps.
+     */
+    void buildCollisionGrids();
+
+    /**
+     * @brief Adds the solid cells touching a rectangle to a list of collision rectangles.
+     * 
+     * Horizontal runs of solid cells become one rectangle, reaching a few cells past the tested one,
+     * and runs spanning the same columns on consecutive rows are stacked. An entity sliding along a
+     * floor or a wall then sees one surface instead of catching on the seams between tiles.
+     * 
+     * @param p_other The rectangle to check for collisions.
+     * @param p_others The rectangles of the solid cells are appended to it.
+     */
+    void addSolidCells(const Rectangle &p_other, std::vector<Rectangle> &p_others) const;
+
     /**
-     * @brief Gets the position of a tile in the tileset.
+     * @brief Adds the animated tile of a gid to a layer, keeping the layer's tiles in map order.
      * 
-     * @param p_tls The tileset.
-     * @param p_gid The global tile ID.
-     * @param p_tileWidth The width of the tile.
-     * @param p_tileHeight The height of the tile.
-     * @return Vector2f The position of the tile in the tileset.
+     * @param p_layer Index of the map layer.
+     * @param p_x Column of the cell.
+     * @param p_y Row of the cell.
+     * @param p_gid The animated gid.
      */
-    Vector2f getTilesetPosition(Tileset p_tls, int p_gid, int p_tileWidth, int p_tileHeight);
+    void insertAnimatedTile(int p_layer, int p_x, int p_y, uint32_t p_gid);
 
     /**
-     * @brief Loads the map and resources for the level.
+     * @brief Removes the animated tile of a cell from a layer, if it has one.
+     * 
+     * @param p_layer Index of the map layer.
+     * @param p_x Column of the cell.
+     * @param p_y Row of the cell.
+     */
+    void removeAnimatedTile(int p_layer, int p_x, int p_y);
+
+    /**
+     * @brief Moves the animated tiles following a row of a layer after a tile was inserted or removed in it.
+     * 
+     * @param p_layer Index of the map layer.
+     * @param p_row The row the tile was inserted into or removed from.
+     * @param p_delta 1 after an insertion, -1 after a removal.
+     */
+    void shiftAnimatedTiles(int p_layer, int p_row, int p_delta);
+
+    /**
+     * @brief Recomputes the solidity of a cell from the tiles of every layer, with LevelTemplate::isSolid().
+     * 
+     * @param p_x Column of the cell.
+     * @param p_y Row of the cell.
+     */
+    void updateSolidity(int p_x, int p_y);
+
+    /**
+     * @brief Builds the level's tiles, geometry and enemies from a loaded map.
+     * 
+     * Every gid is resolved through the template's lookup table, so this is linear in the number of tiles.
+     * 
+     * @param p_template The map and tileset textures of the level.
+     * @param p_graphics Graphics context used by the level's enemies.
+     * @param p_buildTiles False when the tiles are streamed, so only the geometry and enemies are built.
+     */
+    void buildFromTemplate(const LevelTemplate &p_template, Graphics &p_graphics, bool p_buildTiles);
+
+    /**
+     * @brief Marks the solid cells of a streamed infinite map in the collision mask.
+     * 
+     * Chunks are decoded one at a time into a chunk sized buffer, so the whole map is never held
+     * densely in memory. Layers that can't hold a solid cell are not decoded at all.
      * 
-     * @param p_mapName Name of the map file to load.
-     * @param p_graphics Graphics context used for loading textures.
+     * @param p_template The map and tileset textures of the level.
      */
-    void loadMap(std::string p_mapName, Graphics &p_graphics);
+    void buildStreamedCollisionMask(const LevelTemplate &p_template);
 };
 
 /**
@@ -163,7 +422,7 @@ private:
  * The Tileset struct holds a texture and the first global tile ID for the tileset.
  */
 struct Tileset {
-    SDL_Texture* Texture; ///< Texture for the tileset.
+    std::shared_ptr<SDL_Texture> Texture; ///< Texture for the tileset, shared through the Graphics texture cache.
     int FirstGid; ///< First global tile ID in the tileset.
 
     /**
@@ -179,7 +438,7 @@ struct Tileset {
      * @param p_texture The texture for the tileset.
      * @param p_firstGid The first global tile ID in the tileset.
      */
-    Tileset(SDL_Texture* p_texture, int p_firstGid) :
+    Tileset(std::shared_ptr<SDL_Texture> p_texture, int p_firstGid) :
         Texture(p_texture),
         FirstGid(p_firstGid)
     {}
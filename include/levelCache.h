@@ -0,0 +1,241 @@
+/**
+ * @file levelCache.h
+ * @brief Defines the LevelCache class, which keeps loaded maps around so levels can be re-entered cheaply.
+ */
+
+#ifndef LEVELCACHE_H
+#define LEVELCACHE_H
+
+#include "level.h"
+#include "mapData.h"
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Graphics;
+
+/**
+ * @struct TileGid
+ * @brief What a global tile ID stands for in a map, precomputed once per map.
+ */
+struct TileGid {
+    int Tileset; ///< Index of the gid's tileset in LevelTemplate::Tilesets, -1 if no tileset covers it.
+    Vector2f SourcePosition; ///< Position of the tile in its tileset image.
+    int Animation; ///< Index of the animation starting at the gid in MapData::Animations, -1 if none.
+    bool Solid; ///< True if the tile's tileset marks it solid.
+};
+
+/**
+ * @struct LevelTemplate
+ * @brief The immutable part of a level: its parsed map and its tileset textures.
+ *
+ * A Level is instantiated from a template by building its runtime state (tiles, batches, grids, enemies),
+ * without reading any file or uploading any texture.
+ */
+struct LevelTemplate {
+    std::string Name; ///< Name of the map.
+    std::shared_ptr<const MapData> Map; ///< The parsed map.
+    std::vector<Tileset> Tilesets; ///< Tileset textures, in the map's tileset order.
+    std::vector<int> TilesetColumns; ///< Number of tile columns in each tileset image, 0 if unknown.
+    std::vector<TileGid> Gids; ///< Lookup table indexed by gid, covering every tile of every tileset.
+    std::vector<std::vector<Vector2f>> AnimationFrames; ///< Source position of each frame of each animation.
+    int LastTileset; ///< Index of the tileset with the highest first gid, -1 if there is no tileset.
+    size_t Bytes; ///< Estimated memory held by the template (map data and textures), in bytes.
+
+    /**
+     * @brief Looks up a gid in O(1).
+     *
+     * Gids past the table (beyond the last tile of every tileset) belong to the tileset
+     * with the highest first gid, like Tiled resolves them.
+     *
+     * @param p_gid The global tile ID.
+     * @return TileGid: What the gid stands for. Its Tileset is -1 for gid 0 and unknown gids.
+     */
+    TileGid getGid(int p_gid) const;
+
+    /**
+     * @brief Tells whether a tile makes its cell solid, the one rule the collision mask follows.
+     *
+     * Any tile of the collision layer is solid. On other layers a tile is solid when its tileset marks
+     * it so, animated or not, and a gid no tileset covers never is.
+     *
+     * @param p_gid The global tile ID, 0 for no tile.
+     * @param p_collisionLayer True if the tile is on the collision layer.
+     * @return bool: True if the cell is solid.
+     */
+    bool isSolid(uint32_t p_gid, bool p_collisionLayer) const;
+
+    /**
+     * @brief Creates the tile of a gid and adds it to the static or the animated tiles.
+     *
+     * Only reads the template, so loading threads can call it.
+     *
+     * @param p_gid The global tile ID. Nothing is added for gid 0 or an unknown gid.
+     * @param p_position Position of the tile in map pixels.
+     * @param p_tiles Static tiles the tile is added to.
+     * @param p_animatedTiles Animated tiles the tile is added to if the gid is animated.
+     */
+    void appendTile(uint32_t p_gid, Vector2f p_position, std::vector<Tile> &p_tiles,
+                    std::vector<AnimatedTile> &p_animatedTiles) const;
+};
+
+/**
+ * @class LevelCache
+ * @brief Loads level templates by map name and keeps the most recently used ones in memory.
+ *
+ * The templates' total size is capped: when a new template goes over the cap, the least recently used
+ * templates are dropped. A dropped template stays alive as long as a level still uses its textures.
+ */
+class LevelCache {
+public:
+    /**
+     * @brief Constructs an empty cache.
+     *
+     * @param p_maxBytes Memory the cached templates may use before the least recently used are dropped.
+     */
+    LevelCache(size_t p_maxBytes = DEFAULT_MAX_BYTES);
+
+    /**
+     * @brief Gets the template of a map, loading it on a miss.
+     *
+     * @param p_mapName Name of the map.
+     * @param p_graphics Graphics context used to load the tileset textures.
+     * @return std::shared_ptr<const LevelTemplate>: The template. Its map is empty if the map failed to load.
+     */
+    std::shared_ptr<const LevelTemplate> getTemplate(const std::string &p_mapName, Graphics &p_graphics);
+
+    /**
+     * @brief Creates a fresh level from the template of a map.
+     *
+     * @param p_mapName Name of the map.
+     * @param p_graphics Graphics context used by the level's enemies.
+     * @return Level: The new level.
+     */
+    Level createLevel(const std::string &p_mapName, Graphics &p_graphics);
+
+    /**
+     * @brief Sets how levels created from infinite maps are loaded.
+     *
+     * @param p_screens 0 to load infinite maps whole, otherwise the number of screens around the player
+     *                  whose chunks are kept loaded by a background thread.
+     */
+    inline void setStreamingRadius(int p_screens) { this->_streamingRadius = p_screens; }
+
+    /**
+     * @brief Sets how levels created from now on draw their tile layers.
+     *
+     * @param p_mode The draw mode, tiledraw::BATCHED by default.
+     */
+    inline void setTileDrawMode(tiledraw::Mode p_mode) { this->_tileDrawMode = p_mode; }
+
+    /**
+     * @brief Adds a template loaded elsewhere, e.g. by a LevelPreloader.
+     *
+     * Does nothing if the map is already cached.
+     *
+     * @param p_template The template to add.
+     */
+    void insert(const std::shared_ptr<const LevelTemplate> &p_template);
+
+    /**
+     * @brief Creates a template from a loaded map and its tileset textures.
+     *
+     * @param p_mapName Name of the map.
+     * @param p_map The parsed map.
+     * @param p_tilesets The map's tileset textures, in the map's tileset order.
+     * @return std::shared_ptr<LevelTemplate>: The template, with its memory estimated.
+     */
+    static std::shared_ptr<LevelTemplate> makeTemplate(const std::string &p_mapName,
+        const std::shared_ptr<const MapData> &p_map, const std::vector<Tileset> &p_tilesets);
+
+    /**
+     * @brief Checks if a map's template is cached.
+     *
+     * @param p_mapName Name of the map.
+     * @return bool: True if the template is in the cache.
+     */
+    bool contains(const std::string &p_mapName) const;
+
+    /**
+     * @brief Drops every cached template.
+     */
+    void clear();
+
+    /**
+     * @brief Gets the estimated memory used by the cached templates.
+     *
+     * @return size_t: The memory in bytes.
+     */
+    inline size_t getBytes() const { return this->_bytes; }
+
+    /**
+     * @brief Gets the memory cap of the cache.
+     *
+     * @return size_t: The cap in bytes.
+     */
+    inline size_t getMaxBytes() const { return this->_maxBytes; }
+
+    /**
+     * @brief Gets the number of cached templates.
+     *
+     * @return int: The number of templates.
+     */
+    inline int getCount() const { return this->_entries.size(); }
+
+    /**
+     * @brief Gets the number of template requests served from the cache.
+     *
+     * @return unsigned int: The number of hits.
+     */
+    inline unsigned int getHits() const { return this->_hits; }
+
+    /**
+     * @brief Gets the number of template requests that had to load the map.
+     *
+     * @return unsigned int: The number of misses.
+     */
+    inline unsigned int getMisses() const { return this->_misses; }
+
+    static const size_t DEFAULT_MAX_BYTES = 32 * 1024 * 1024; ///< Default memory cap, 32 MB.
+
+private:
+    /**
+     * @struct Entry
+     * @brief A cached template and its place in the use order.
+     */
+    struct Entry {
+        std::shared_ptr<const LevelTemplate> Template; ///< The cached template.
+        std::list<std::string>::iterator Use; ///< Position of the map in _useOrder.
+    };
+
+    /**
+     * @brief Loads a map and its tileset textures into a new template.
+     *
+     * @param p_mapName Name of the map.
+     * @param p_graphics Graphics context used to load the tileset textures.
+     * @return std::shared_ptr<LevelTemplate>: The template, or null if the map failed to load.
+     */
+    std::shared_ptr<LevelTemplate> loadTemplate(const std::string &p_mapName, Graphics &p_graphics);
+
+    /**
+     * @brief Drops the least recently used templates until the cache fits in its cap.
+     *
+     * The most recently used template is always kept, even when it alone is over the cap.
+     */
+    void evict();
+
+    std::map<std::string, Entry> _entries; ///< Cached templates by map name.
+    std::list<std::string> _useOrder; ///< Cached map names, most recently used first.
+    size_t _maxBytes; ///< Memory cap in bytes.
+    size_t _bytes; ///< Memory used by the cached templates in bytes.
+    unsigned int _hits; ///< Requests served from the cache.
+    unsigned int _misses; ///< Requests that loaded the map.
+    int _streamingRadius; ///< Screens of chunks kept loaded around the player in infinite maps, 0 to load them whole.
+    tiledraw::Mode _tileDrawMode; ///< How the levels created draw their tile layers.
+};
+
+#endif /* LEVELCACHE_H */
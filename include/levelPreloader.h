@@ -0,0 +1,96 @@
+/**
+ * @file levelPreloader.h
+ * @brief Defines the LevelPreloader class, which loads maps on a background thread.
+ */
+
+#ifndef LEVELPRELOADER_H
+#define LEVELPRELOADER_H
+
+#include "mapData.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct SDL_Surface;
+class Graphics;
+class LevelCache;
+
+/**
+ * @class LevelPreloader
+ * @brief Loads maps ahead of time on a worker thread and hands them to a LevelCache.
+ *
+ * The worker does the slow part of a load: reading and parsing the map and decoding its tileset images.
+ * The renderer can only be used from the main thread, so the texture upload happens in poll(),
+ * after which the level is in the cache and entering it is only a matter of instantiating it.
+ */
+class LevelPreloader {
+public:
+    /**
+     * @brief Starts the worker thread.
+     */
+    LevelPreloader();
+
+    /**
+     * @brief Stops the worker thread and frees any load that was never collected.
+     */
+    ~LevelPreloader();
+
+    LevelPreloader(const LevelPreloader&) = delete;
+    LevelPreloader &operator=(const LevelPreloader&) = delete;
+
+    /**
+     * @brief Queues a map for loading, unless it is already queued or waiting to be collected.
+     *
+     * @param p_mapName Name of the map.
+     */
+    void request(const std::string &p_mapName);
+
+    /**
+     * @brief Uploads the textures of finished loads and adds them to a cache. Call from the main thread.
+     *
+     * @param p_levelCache The cache receiving the loaded levels.
+     * @param p_graphics Graphics context used to upload the textures.
+     * @return int: The number of levels added.
+     */
+    int poll(LevelCache &p_levelCache, Graphics &p_graphics);
+
+    /**
+     * @brief Checks if a map is queued, loading or waiting to be collected.
+     *
+     * @param p_mapName Name of the map.
+     * @return bool: True if the map is still in flight.
+     */
+    bool isPending(const std::string &p_mapName);
+
+private:
+    /**
+     * @struct LoadedMap
+     * @brief A map loaded by the worker, with its decoded tileset images.
+     */
+    struct LoadedMap {
+        std::string Name; ///< Name of the map.
+        std::shared_ptr<MapData> Map; ///< The parsed map, null if it failed to load.
+        std::vector<SDL_Surface*> Surfaces; ///< Decoded tileset images, in the map's tileset order. Entries may be NULL.
+    };
+
+    /**
+     * @brief Worker thread body, loading queued maps until the preloader is destroyed.
+     */
+    void run();
+
+    std::thread _worker; ///< The loading thread.
+    std::mutex _mutex; ///< Guards everything below.
+    std::condition_variable _wakeUp; ///< Signaled when a map is queued or the worker must stop.
+    std::deque<std::string> _queue; ///< Maps waiting to be loaded.
+    std::vector<LoadedMap> _finished; ///< Maps loaded but not collected by poll() yet.
+    std::set<std::string> _pending; ///< Every map queued, loading or finished but not collected.
+    bool _stopping; ///< Set when the worker must exit.
+};
+
+#endif /* LEVELPRELOADER_H */
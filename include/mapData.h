@@ -0,0 +1,204 @@
+/**
+ * @file mapData.h
+ * @brief Defines the MapData class, the parsed content of a map file independent of SDL.
+ *
+ * A map can come from a Tiled .tmx file or from a cooked .cmap file made by the map cooker tool.
+ * Both end up in a MapData, which the Level then builds its tiles, textures and enemies from.
+ */
+
+#ifndef MAPDATA_H
+#define MAPDATA_H
+
+#include "globals.h"
+#include "rectangle.h"
+#include "slope.h"
+#include "animatedTile.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct TilesetData
+ * @brief A tileset referenced by a map.
+ */
+struct TilesetData {
+    std::string ImagePath; ///< Path of the tileset image, as written in the map.
+    int FirstGid; ///< First global tile ID in the tileset.
+    int ImageWidth; ///< Width of the tileset image in pixels, 0 if the map doesn't say.
+    int ImageHeight; ///< Height of the tileset image in pixels, 0 if the map doesn't say.
+};
+
+/**
+ * @struct ChunkData
+ * @brief A rectangular piece of a tile layer in an infinite map.
+ *
+ * Encoded chunks keep their payload as written in the map and are decoded on demand,
+ * so a huge map only holds the compressed form of the chunks nobody is looking at.
+ */
+struct ChunkData {
+    int X; ///< Left of the chunk in tiles, relative to the map's origin.
+    int Y; ///< Top of the chunk in tiles, relative to the map's origin.
+    int Width; ///< Width of the chunk in tiles.
+    int Height; ///< Height of the chunk in tiles.
+    std::string Encoding; ///< "csv" or "base64", empty if Gids holds the decoded chunk.
+    std::string Compression; ///< Compression of a base64 payload, empty if uncompressed.
+    std::string Payload; ///< Encoded gids, as the text of the <chunk> element.
+    std::vector<uint32_t> Gids; ///< Decoded gids, for chunks stored in the legacy XML form.
+};
+
+/**
+ * @struct LayerData
+ * @brief A tile layer, one global tile ID per cell in row major order (0 for an empty cell).
+ *
+ * Layers of infinite maps leave Gids empty and are made of Chunks instead.
+ * A layer named "collision" isn't drawn: its non-empty cells mark the solid cells of the map.
+ */
+struct LayerData {
+    std::vector<uint32_t> Gids; ///< Global tile IDs, width * height of them.
+    std::vector<ChunkData> Chunks; ///< Chunks of the layer, for infinite maps.
+    bool Collision; ///< True for the collision layer.
+};
+
+/**
+ * @struct DoorData
+ * @brief A door of the map, with its rectangle in unscaled map pixels.
+ */
+struct DoorData {
+    Rectangle Rect; ///< The door's rectangle, before the sprite scale is applied.
+    std::string Destination; ///< Name of the map the door leads to.
+};
+
+/**
+ * @struct EnemyData
+ * @brief An enemy spawn of the map.
+ */
+struct EnemyData {
+    std::string Name; ///< Kind of enemy, e.g. "bat".
+    Vector2f Position; ///< Spawn position in world pixels.
+};
+
+/**
+ * @class MapData
+ * @brief Everything a Level needs from a map file, without any SDL resource.
+ *
+ * Positions of collision rects, slopes, spawns and enemies are stored in world pixels
+ * (already multiplied by the sprite scale), exactly as the Level uses them.
+ */
+class MapData {
+public:
+    /**
+     * @brief Default constructor. Creates an empty map.
+     */
+    MapData();
+
+    /**
+     * @brief Loads a map by name from res/maps.
+     *
+     * Uses the cooked .cmap file when there is one that is not older than the .tmx,
+     * and parses the .tmx otherwise.
+     *
+     * @param p_mapName Name of the map, without extension.
+     * @param p_map The map to fill.
+     * @return bool: True if the map was loaded.
+     */
+    static bool load(const std::string &p_mapName, MapData &p_map);
+
+    /**
+     * @brief Parses a Tiled .tmx file.
+     *
+     * @param p_filePath Path of the .tmx file.
+     * @param p_map The map to fill.
+     * @return bool: True if the file was read and parsed.
+     */
+    static bool loadTmx(const std::string &p_filePath, MapData &p_map);
+
+    /**
+     * @brief Reads a cooked .cmap file.
+     *
+     * The file is memory mapped and decoded in a single pass; a file with a wrong magic,
+     * an unknown version or a truncated body is rejected.
+     *
+     * @param p_filePath Path of the .cmap file.
+     * @param p_map The map to fill.
+     * @return bool: True if the file was read and is valid.
+     */
+    static bool loadCooked(const std::string &p_filePath, MapData &p_map);
+
+    /**
+     * @brief Writes the map as a cooked .cmap file.
+     *
+     * @param p_filePath Path of the .cmap file to write.
+     * @return bool: True if the file was written.
+     */
+    bool saveCooked(const std::string &p_filePath) const;
+
+    /**
+     * @brief Fills SourcePositions from the tilesets' image sizes.
+     *
+     * Tilesets whose image size is unknown are skipped, their tiles keep an empty position.
+     */
+    void computeSourcePositions();
+
+    /**
+     * @brief Decodes the gids of a chunk.
+     *
+     * Safe to call from any thread, the chunk isn't modified.
+     *
+     * @param p_chunk The chunk.
+     * @param p_gids Filled with the chunk's Width * Height gids, row major.
+     * @return bool: False if the payload can't be decoded.
+     */
+    static bool decodeChunk(const ChunkData &p_chunk, std::vector<uint32_t> &p_gids);
+
+    /**
+     * @brief Gets the dense gids of a layer, decoding and placing its chunks for infinite maps.
+     *
+     * @param p_layer Index of the layer.
+     * @param p_gids Filled with Size.x * Size.y gids, row major.
+     */
+    void getLayerGids(int p_layer, std::vector<uint32_t> &p_gids) const;
+
+    /**
+     * @brief Estimates the heap memory used by the map.
+     *
+     * @return size_t: The size of the map and of everything it owns, in bytes.
+     */
+    size_t getMemorySize() const;
+
+    /**
+     * @brief Checks if the map marks solid cells, through solid tiles or a collision layer.
+     *
+     * @return bool: True if the level should build a collision mask.
+     */
+    bool hasSolidTiles() const;
+
+    Vector2f Size; ///< Size of the map in tiles, the bounds of every chunk for infinite maps.
+    Vector2f TileSize; ///< Size of a tile in map pixels.
+    Vector2f SpawnPoint; ///< Player spawn point in world pixels.
+    bool Infinite; ///< True for Tiled infinite maps, whose layers are made of chunks.
+    Vector2f Origin; ///< For infinite maps, the top left tile of the chunks' bounds. Everything is stored relative to it.
+
+    std::vector<TilesetData> Tilesets; ///< Tilesets, in file order.
+    std::vector<AnimatedTileInfo> Animations; ///< Animated tiles of every tileset.
+    std::vector<uint32_t> SolidGids; ///< Gids of the tiles whose "solid" property is set in their tileset.
+    std::vector<LayerData> Layers; ///< Tile layers, in draw order.
+    std::vector<Vector2f> SourcePositions; ///< Position of each gid in its tileset image, indexed by gid. May be empty.
+
+    std::vector<Rectangle> CollisionRects; ///< Solid rectangles in world pixels.
+    std::vector<Slope> Slopes; ///< Slopes in world pixels.
+    std::vector<DoorData> Doors; ///< Doors to other maps.
+    std::vector<EnemyData> Enemies; ///< Enemy spawns.
+
+    static const uint32_t COOKED_VERSION = 3; ///< Version written in cooked files, bumped on any format change.
+
+private:
+    /**
+     * @brief Moves the origin of an infinite map to the top left of its chunks and sizes the map to them.
+     *
+     * Chunks and every object are moved along with the origin.
+     */
+    void placeChunks();
+};
+
+#endif /* MAPDATA_H */
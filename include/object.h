@@ -15,6 +15,8 @@ public:
 
     const inline bool getActive() const { return this->_isActive; }
 
+    inline void setActive(bool p_active) { this->_isActive = p_active; }
+
 private:
     bool _isActive; ///< True if the player still hasn't used this object, (meaning it's still on the map).
 };
@@ -14,12 +14,14 @@
 #include "globals.h"
 #include "slope.h"
 #include "level.h"
+#include "levelCache.h"
 #include "enemy.h"
 #include "object.h"
 
 #include <string>
 
 class Graphics;
+class Camera;
 class Door;
 
 /**
@@ -49,15 +51,22 @@ public:
      * @brief Draws the player on the screen.
      * 
      * @param p_graphics Graphics context to draw the player.
+     * @param p_camera Camera converting the player's world position to the screen.
+     * @param p_alpha How far the frame is between the previous and the current tick, from 0 to 1.
      */
-    void draw(Graphics &p_graphics);
+    void draw(Graphics &p_graphics, const Camera &p_camera, float p_alpha);
 
     /**
      * @brief Updates the player's position and animations.
      * 
+     * The move is swept against the level's tiles one axis at a time, horizontally then vertically.
+     * Each axis stops at the first tile found along the whole move, so the player can't pass through
+     * thin geometry however long the update is.
+     * 
      * @param p_elapsedTime Time elapsed since the last update.
+     * @param p_level The level whose tiles block the player.
      */
-    void update(float p_elapsedTime);
+    void update(float p_elapsedTime, Level &p_level);
 
     /**
      * @brief Moves the player left by -dx.
@@ -136,10 +145,11 @@ public:
      * @brief Handles collisions with doors.
      * 
      * @param p_others A vector of doors.
-     * @param p_level The current level.
+     * @param p_level The current level, replaced by the door's destination.
+     * @param p_levelCache The cache the destination level is created from.
      * @param p_graphics The graphics context.
      */
-    void handleDoorCollision(std::vector<Door> &p_others, Level &p_level, Graphics &p_graphics);
+    void handleDoorCollision(std::vector<Door> &p_others, Level &p_level, LevelCache &p_levelCache, Graphics &p_graphics);
 
     /**
      * @brief Handles collisions with enemies.
@@ -186,10 +196,11 @@ public:
     /**
      * @brief Resets the level when the player dies.
      * 
-     * @param p_level The current level.
+     * @param p_level The current level, replaced by a fresh first level.
+     * @param p_levelCache The cache the fresh level is created from.
      * @param p_graphics The graphics context.
      */
-    void resetLevelOnDeath(Level &p_level, Graphics &p_graphics);
+    void resetLevelOnDeath(Level &p_level, LevelCache &p_levelCache, Graphics &p_graphics);
 
 private:
     float _dx, _dy; ///< Delta x and y for player's movement.
@@ -201,6 +212,20 @@ private:
     
     int _maxHealth; ///< The maximum health of the player.
     int _currentHealth; ///< The current health of the player.
+
+    std::vector<Rectangle> _sweepHits; ///< Scratch buffer for the tiles along a move.
+
+    /**
+     * @brief Moves the player along one axis, stopping one pixel short of the first tile in the way.
+     * 
+     * Tiles the player already overlaps are ignored, handleTileCollisions() pushes the player out of those.
+     * 
+     * @param p_level The level whose tiles block the player.
+     * @param p_distance The move in world pixels, negative to go left or up.
+     * @param p_horizontal True to move along x, false to move along y.
+     * @return bool: True if a tile stopped the move.
+     */
+    bool sweep(Level &p_level, float p_distance, bool p_horizontal);
 };
 
 #endif /* PLAYER */
\ No newline at end of file
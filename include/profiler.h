@@ -0,0 +1,98 @@
+/**
+ * @file profiler.h
+ * @brief Scoped zone profiler, compiled in only when ENABLE_PROFILER is defined.
+ *
+ * PROFILE_ZONE("name") times the rest of the enclosing scope and PROFILE_FRAME() closes the current
+ * frame. Without ENABLE_PROFILER both expand to nothing, so the zones cost nothing in a normal build.
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#ifdef ENABLE_PROFILER
+
+#include <SDL2/SDL.h>
+#include <string>
+
+/**
+ * @namespace profiler
+ * @brief Records timed zones of the main thread into a ring buffer of the last frames.
+ *
+ * Zones are kept per frame in fixed size rings, so recording never allocates and only the most
+ * recent frames survive. dump() writes them in Chrome's trace event format, which chrome://tracing,
+ * Perfetto and speedscope open, with one complete ("X") event per zone and one per frame.
+ * Zone names must be string literals, only their pointer is stored.
+ */
+namespace profiler {
+    /**
+     * @brief Records a finished zone into the current frame. Dropped if the frame is full.
+     *
+     * @param p_name Name of the zone, a string literal.
+     * @param p_start Performance counter when the zone began.
+     * @param p_end Performance counter when the zone ended.
+     */
+    void record(const char* p_name, Uint64 p_start, Uint64 p_end);
+
+    /**
+     * @brief Closes the current frame and starts the next one.
+     */
+    void endFrame();
+
+    /**
+     * @brief Writes the frames still in the ring as Chrome trace event JSON.
+     *
+     * @param p_filePath The file to write.
+     * @return bool: True if the file was written.
+     */
+    bool dump(const std::string &p_filePath);
+
+    /**
+     * @brief Gets the number of frames closed since the program started.
+     *
+     * @return unsigned long long: The frame count.
+     */
+    unsigned long long getFrameCount();
+
+    /**
+     * @class Zone
+     * @brief Times its own lifetime and records it as a zone when destroyed.
+     */
+    class Zone {
+    public:
+        /**
+         * @brief Starts timing a zone.
+         *
+         * @param p_name Name of the zone, a string literal.
+         */
+        explicit Zone(const char* p_name) :
+            _name(p_name),
+            _start(SDL_GetPerformanceCounter())
+        {}
+
+        /**
+         * @brief Stops timing and records the zone.
+         */
+        ~Zone(){ profiler::record(this->_name, this->_start, SDL_GetPerformanceCounter()); }
+
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+
+    private:
+        const char* _name; ///< Name of the zone.
+        Uint64 _start; ///< Performance counter when the zone began.
+    };
+}
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) profiler::Zone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_FRAME() profiler::endFrame()
+
+#else
+
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_FRAME() ((void)0)
+
+#endif /* ENABLE_PROFILER */
+
+#endif /* PROFILER_H */
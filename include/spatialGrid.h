@@ -0,0 +1,121 @@
+/**
+ * @file spatialGrid.h
+ * @brief Defines the SpatialGrid class used as a broad phase for level collision queries.
+ */
+
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include "globals.h"
+#include "rectangle.h"
+
+#include <vector>
+
+/**
+ * @class SpatialGrid
+ * @brief Uniform grid that buckets rectangles by the cells they overlap.
+ *
+ * Every inserted rectangle gets an id (its insertion index) and is stored in each cell it touches.
+ * A query only visits the cells overlapped by the query rectangle, so its cost depends on the size
+ * of the rectangle instead of the number of entries in the level. Rectangles outside the grid are
+ * clamped into the border cells, so nothing is ever dropped.
+ */
+class SpatialGrid {
+public:
+    /**
+     * @brief Default constructor. Creates an empty grid that never returns anything.
+     */
+    SpatialGrid();
+
+    /**
+     * @brief Constructs a grid covering a given world area.
+     *
+     * @param p_cellSize Size of a single cell in world pixels.
+     * @param p_worldSize Size of the covered area in world pixels.
+     */
+    SpatialGrid(Vector2f p_cellSize, Vector2f p_worldSize);
+
+    /**
+     * @brief Removes every entry from the grid, keeping its dimensions.
+     */
+    void clear();
+
+    /**
+     * @brief Inserts a rectangle into the grid.
+     *
+     * @param p_rect The rectangle to insert.
+     * @return int: The id of the new entry, equal to the number of previous insertions.
+     */
+    int insert(const Rectangle &p_rect);
+
+    /**
+     * @brief Moves an existing entry to a new rectangle.
+     *
+     * Cheap when the entry stays in the same cells, which is the common case for moving enemies:
+     * the buckets are only touched when the covered cell range actually changes.
+     *
+     * @param p_id The id returned by insert().
+     * @param p_rect The new rectangle of the entry.
+     */
+    void move(int p_id, const Rectangle &p_rect);
+
+    /**
+     * @brief Collects the ids of every entry sharing a cell with a rectangle.
+     *
+     * The ids are appended to p_ids without duplicates and in ascending order, so callers
+     * see candidates in the same order as a linear scan would. Candidates still need a narrow phase test.
+     *
+     * @param p_rect The rectangle to query.
+     * @param p_ids The vector the candidate ids are appended to.
+     */
+    void query(const Rectangle &p_rect, std::vector<int> &p_ids);
+
+    /**
+     * @brief Gets the number of entries in the grid.
+     *
+     * @return int: The number of entries.
+     */
+    inline int getCount() const { return this->_spans.size(); }
+
+private:
+    /**
+     * @struct CellSpan
+     * @brief Inclusive range of cells covered by a rectangle.
+     */
+    struct CellSpan {
+        int x0, y0, x1, y1;
+
+        bool operator==(const CellSpan &p_other) const {
+            return this->x0 == p_other.x0 && this->y0 == p_other.y0 &&
+                   this->x1 == p_other.x1 && this->y1 == p_other.y1;
+        }
+    };
+
+    /**
+     * @brief Computes the cells covered by a rectangle, clamped to the grid.
+     *
+     * @param p_rect The rectangle.
+     * @return CellSpan: The covered cells.
+     */
+    CellSpan getSpan(const Rectangle &p_rect) const;
+
+    /**
+     * @brief Adds or removes an id from every cell of a span.
+     *
+     * @param p_id The entry id.
+     * @param p_span The cells to update.
+     * @param p_add True to add the id, false to remove it.
+     */
+    void updateCells(int p_id, const CellSpan &p_span, bool p_add);
+
+    Vector2f _cellSize; ///< Size of a cell in world pixels.
+    int _columns; ///< Number of cell columns.
+    int _rows; ///< Number of cell rows.
+
+    std::vector<std::vector<int>> _cells; ///< Ids stored in each cell, row major.
+    std::vector<CellSpan> _spans; ///< Cells currently covered by each entry.
+    std::vector<unsigned int> _stamps; ///< Last query that visited each entry, used to skip duplicates.
+    unsigned int _queryStamp; ///< Id of the current query.
+};
+
+#endif /* SPATIALGRID_H */
@@ -2,6 +2,7 @@
 #define SPRITE
 
 #include <SDL2/SDL.h>
+#include <memory>
 #include <string>
 
 #include "rectangle.h"
@@ -142,10 +143,35 @@ public:
      */
     inline float getY() const { return this->_y; }
 
+    /**
+     * @brief Remembers the current position as the position of the previous simulation tick.
+     * 
+     * Called before each fixed update, and again after a teleport so the sprite doesn't
+     * appear to slide from its old position.
+     */
+    inline void savePreviousPosition() { this->_previousX = this->_x; this->_previousY = this->_y; }
+
+    /**
+     * @brief Gets the x-coordinate between the previous and the current tick.
+     * 
+     * @param p_alpha How far the frame is into the next tick, from 0 to 1.
+     * @return float: The interpolated x-coordinate.
+     */
+    inline float getInterpolatedX(float p_alpha) const { return this->_previousX + (this->_x - this->_previousX) * p_alpha; }
+
+    /**
+     * @brief Gets the y-coordinate between the previous and the current tick.
+     * 
+     * @param p_alpha How far the frame is into the next tick, from 0 to 1.
+     * @return float: The interpolated y-coordinate.
+     */
+    inline float getInterpolatedY(float p_alpha) const { return this->_previousY + (this->_y - this->_previousY) * p_alpha; }
+
 protected:
     SDL_Rect _src; ///< Source rectangle in the sprite sheet.
-    SDL_Texture* _spriteSheet; ///< Texture of the sprite sheet.
+    std::shared_ptr<SDL_Texture> _spriteSheet; ///< Texture of the sprite sheet, shared through the Graphics texture cache.
     float _x, _y; ///< Current position of the sprite.
+    float _previousX, _previousY; ///< Position of the sprite at the previous simulation tick.
     Rectangle _boundingBox; ///< Bounding box of the sprite.
 };
 
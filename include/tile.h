@@ -13,6 +13,7 @@
 
 struct SDL_Texture;
 class Graphics;
+class Camera;
 
 /**
  * @class Tile
@@ -45,14 +46,43 @@ public:
    * 
    * @param p_elapsedTime Time elapsed since the last update.
    */
-   void update(int p_elapsedTime);
+   void update(float p_elapsedTime);
 
    /**
    * @brief Draws the tile to the screen.
    * 
    * @param p_graphics Graphics context used for drawing.
+   * @param p_camera Camera converting the tile's world position to the screen.
    */
-   void draw(Graphics &p_graphics);
+   void draw(Graphics &p_graphics, const Camera &p_camera) const;
+
+   /**
+   * @brief Gets the tileset texture of the tile.
+   * 
+   * @return SDL_Texture*: The tileset texture.
+   */
+   inline SDL_Texture* getTileset() const { return this->_tileset; }
+
+   /**
+   * @brief Gets the size of the tile in tileset pixels.
+   * 
+   * @return Vector2f: The size of the tile.
+   */
+   inline Vector2f getSize() const { return this->_size; }
+
+   /**
+   * @brief Gets the position of the tile within the tileset.
+   * 
+   * @return Vector2f: The tileset position.
+   */
+   inline Vector2f getTilesetPosition() const { return this->_tilesetPosition; }
+
+   /**
+   * @brief Gets the position of the tile in the game world, already scaled.
+   * 
+   * @return Vector2f: The world position.
+   */
+   inline Vector2f getPosition() const { return this->_position; }
 
 protected:
    SDL_Texture* _tileset; ///< Pointer to the SDL_Texture object for the tileset.
@@ -0,0 +1,93 @@
+/**
+ * @file tileBatch.h
+ * @brief Defines the TileBatch class used to draw many tiles of one tileset in a single call.
+ */
+
+#ifndef TILEBATCH_H
+#define TILEBATCH_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+#include "globals.h"
+
+class Graphics;
+
+/**
+ * @class TileBatch
+ * @brief Vertex and index buffers for a group of tiles sharing the same tileset texture.
+ * 
+ * Each tile is stored as a textured quad (4 vertices, 6 indices). The whole batch is submitted
+ * with one SDL_RenderGeometry call instead of one SDL_RenderCopy per tile.
+ */
+class TileBatch {
+public:
+    /**
+     * @brief Default constructor. Creates an empty batch without a texture.
+     */
+    TileBatch();
+
+    /**
+     * @brief Constructs an empty batch for a tileset texture.
+     * 
+     * @param p_texture The tileset texture every tile in the batch is sampled from.
+     */
+    TileBatch(SDL_Texture* p_texture);
+
+    /**
+     * @brief Adds a tile to the batch.
+     * 
+     * @param p_tilesetPosition Position of the tile in the tileset, in tileset pixels.
+     * @param p_size Size of the tile in tileset pixels.
+     * @param p_position Position of the tile on the screen, already scaled.
+     * @return int: The index of the tile's quad in the batch.
+     */
+    int addTile(Vector2f p_tilesetPosition, Vector2f p_size, Vector2f p_position);
+
+    /**
+     * @brief Changes the part of the tileset a quad samples from.
+     * 
+     * Only the texture coordinates of that quad are rewritten, its position stays the same.
+     * 
+     * @param p_quad The index returned by addTile().
+     * @param p_tilesetPosition New position of the tile in the tileset.
+     * @param p_size Size of the tile in tileset pixels.
+     */
+    void setTileSource(int p_quad, Vector2f p_tilesetPosition, Vector2f p_size);
+
+    /**
+     * @brief Removes every tile from the batch, keeping the allocated buffers for reuse.
+     */
+    void clear();
+
+    /**
+     * @brief Draws every tile in the batch with a single geometry call.
+     * 
+     * @param p_graphics Graphics context used for rendering.
+     */
+    void draw(Graphics &p_graphics);
+
+    /**
+     * @brief Gets the texture of the batch.
+     * 
+     * @return SDL_Texture*: The tileset texture.
+     */
+    inline SDL_Texture* getTexture() const { return this->_texture; }
+
+    /**
+     * @brief Gets the number of tiles in the batch.
+     * 
+     * @return int: The number of quads.
+     */
+    inline int getTileCount() const { return this->_vertices.size() / 4; }
+
+private:
+    SDL_Texture* _texture; ///< Tileset texture the batch samples from.
+    float _textureWidth; ///< Width of the texture, used to normalize texture coordinates.
+    float _textureHeight; ///< Height of the texture, used to normalize texture coordinates.
+
+    std::vector<SDL_Vertex> _vertices; ///< Four vertices per tile.
+    std::vector<int> _indices; ///< Six indices per tile, two triangles.
+};
+
+#endif /* TILEBATCH_H */
@@ -0,0 +1,135 @@
+/**
+ * @file tileChunkCache.h
+ * @brief Defines the TileChunkCache class, which keeps static tiles pre-rendered in chunk textures.
+ */
+
+#ifndef TILECHUNKCACHE_H
+#define TILECHUNKCACHE_H
+
+#include <memory>
+#include <vector>
+
+#include "globals.h"
+#include "rectangle.h"
+#include "tileBatch.h"
+#include "tileGrid.h"
+
+class Graphics;
+class Camera;
+struct LevelTemplate;
+struct SDL_Texture;
+
+/**
+ * @class TileChunkCache
+ * @brief Composites static tiles into square render-target textures and draws those instead.
+ * 
+ * The world is split into chunks of a fixed size. A chunk's tiles are drawn into its texture the first
+ * time it is needed, after which drawing the chunk is a single blit. A chunk is only re-rendered when
+ * it is invalidated, i.e. when a tile inside it changes or the renderer loses its targets.
+ * The tiles are read from the level's TileGrid when a chunk is rendered, so the cache holds no tile list.
+ */
+class TileChunkCache {
+public:
+    /**
+     * @brief Default constructor. Creates a cache without any chunk.
+     */
+    TileChunkCache();
+
+    /**
+     * @brief Constructs a cache covering a world area.
+     * 
+     * @param p_worldSize Size of the world in pixels, already scaled.
+     * @param p_chunkSize Width and height of a chunk in pixels.
+     */
+    TileChunkCache(Vector2f p_worldSize, int p_chunkSize);
+
+    /**
+     * @brief Sets the size of the grid's cells and marks every chunk dirty.
+     * 
+     * @param p_tileSize Size of a tile in tileset pixels, before scaling.
+     */
+    void build(Vector2f p_tileSize);
+
+    /**
+     * @brief Marks the chunks overlapping an area as needing to be re-rendered.
+     * 
+     * @param p_area The changed area, in world pixels.
+     */
+    void invalidate(const Rectangle &p_area);
+
+    /**
+     * @brief Marks every chunk as needing to be re-rendered.
+     */
+    void invalidateAll();
+
+    /**
+     * @brief Draws the cached chunks on the screen, re-rendering the dirty ones first.
+     * 
+     * Chunks outside the camera view are neither drawn nor re-rendered.
+     * 
+     * Layers are drawn in order, so tiles of later layers cover earlier ones like they do when drawn one by one.
+     * 
+     * @param p_graphics Graphics context used for rendering.
+     * @param p_camera Camera converting world positions to the screen.
+     * @param p_grid The static tiles of the level.
+     * @param p_template The template resolving the grid's gids.
+     */
+    void draw(Graphics &p_graphics, const Camera &p_camera, const TileGrid &p_grid, const LevelTemplate &p_template);
+
+private:
+    /**
+     * @struct Chunk
+     * @brief A square region of the world and its pre-rendered texture.
+     */
+    struct Chunk {
+        std::shared_ptr<SDL_Texture> Texture; ///< Render target holding the composited tiles.
+        bool Empty; ///< True if no tile overlaps the chunk, so there is nothing to blit.
+        bool Dirty; ///< True if the texture needs to be re-rendered.
+        bool Failed; ///< True if its texture couldn't be created, its tiles are then drawn live until invalidateAll().
+    };
+
+    /**
+     * @brief Gets the range of grid cells overlapping a chunk.
+     * 
+     * @param p_index Index of the chunk.
+     * @param p_grid The static tiles of the level.
+     * @param p_firstColumn Set to the first column.
+     * @param p_firstRow Set to the first row.
+     * @param p_lastColumn Set to the last column.
+     * @param p_lastRow Set to the last row.
+     * @return bool: False if the tile size is unknown, leaving the range unset.
+     */
+    bool getChunkCells(int p_index, const TileGrid &p_grid, int &p_firstColumn, int &p_firstRow,
+                       int &p_lastColumn, int &p_lastRow) const;
+
+    /**
+     * @brief Draws a chunk's tiles straight to the screen through tileset batches, for chunks without a texture.
+     * 
+     * @param p_graphics Graphics context used for rendering.
+     * @param p_camera Camera converting world positions to the screen.
+     * @param p_index Index of the chunk.
+     * @param p_grid The static tiles of the level.
+     * @param p_template The template resolving the grid's gids.
+     */
+    void drawChunkTiles(Graphics &p_graphics, const Camera &p_camera, int p_index, const TileGrid &p_grid,
+                        const LevelTemplate &p_template);
+
+    /**
+     * @brief Renders a chunk's tiles into its texture. The texture is only created once the chunk has a tile.
+     * 
+     * @param p_graphics Graphics context used for rendering.
+     * @param p_index Index of the chunk.
+     * @param p_grid The static tiles of the level.
+     * @param p_template The template resolving the grid's gids.
+     */
+    void renderChunk(Graphics &p_graphics, int p_index, const TileGrid &p_grid, const LevelTemplate &p_template);
+
+    int _chunkSize; ///< Width and height of a chunk in pixels.
+    Vector2f _tileSize; ///< Size of a grid cell in tileset pixels, before scaling.
+    int _columns; ///< Number of chunk columns.
+    int _rows; ///< Number of chunk rows.
+    std::vector<Chunk> _chunks; ///< Chunks, row major.
+    std::vector<TileBatch> _fallbackBatches; ///< One batch per tileset, only created once a chunk failed.
+};
+
+#endif /* TILECHUNKCACHE_H */
@@ -0,0 +1,118 @@
+/**
+ * @file tileGrid.h
+ * @brief Defines the TileGrid class, which stores the tiles of a level as one gid per cell.
+ */
+
+#ifndef TILEGRID_H
+#define TILEGRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class TileGrid
+ * @brief Dense per-layer grid of global tile IDs.
+ *
+ * A cell only holds its gid (0 for no tile). Its position follows from its index, and its tileset
+ * and source position come from the gid table shared by every level of the map (LevelTemplate::Gids),
+ * so a cell costs 4 bytes instead of a whole Tile.
+ */
+class TileGrid {
+public:
+    /**
+     * @brief Default constructor. Creates a grid without any cell.
+     */
+    TileGrid();
+
+    /**
+     * @brief Constructs a grid of empty cells.
+     *
+     * @param p_width Number of columns.
+     * @param p_height Number of rows.
+     * @param p_layerCount Number of layers.
+     */
+    TileGrid(int p_width, int p_height, int p_layerCount);
+
+    /**
+     * @brief Checks if a cell is inside the grid.
+     *
+     * @param p_x Column of the cell.
+     * @param p_y Row of the cell.
+     * @return bool: True if the cell exists.
+     */
+    inline bool contains(int p_x, int p_y) const {
+        return p_x >= 0 && p_y >= 0 && p_x < this->_width && p_y < this->_height;
+    }
+
+    /**
+     * @brief Gets the gid of a cell. The cell must be inside the grid.
+     *
+     * @param p_layer Layer of the cell.
+     * @param p_x Column of the cell.
+     * @param p_y Row of the cell.
+     * @return uint32_t: The gid, 0 if the cell is empty.
+     */
+    inline uint32_t getGid(int p_layer, int p_x, int p_y) const {
+        return this->_gids[((size_t)p_layer * this->_height + p_y) * this->_width + p_x];
+    }
+
+    /**
+     * @brief Sets the gid of a cell. The cell must be inside the grid.
+     *
+     * @param p_layer Layer of the cell.
+     * @param p_x Column of the cell.
+     * @param p_y Row of the cell.
+     * @param p_gid The gid, 0 to empty the cell.
+     */
+    inline void setGid(int p_layer, int p_x, int p_y, uint32_t p_gid) {
+        this->_gids[((size_t)p_layer * this->_height + p_y) * this->_width + p_x] = p_gid;
+    }
+
+    /**
+     * @brief Gets the gids of a row, so a range of columns can be walked without any lookup.
+     *
+     * @param p_layer Layer of the row.
+     * @param p_y The row.
+     * @return const uint32_t*: The row's getWidth() gids.
+     */
+    inline const uint32_t* getRow(int p_layer, int p_y) const {
+        return &this->_gids[((size_t)p_layer * this->_height + p_y) * this->_width];
+    }
+
+    /**
+     * @brief Gets the number of columns.
+     *
+     * @return int: The width of the grid.
+     */
+    inline int getWidth() const { return this->_width; }
+
+    /**
+     * @brief Gets the number of rows.
+     *
+     * @return int: The height of the grid.
+     */
+    inline int getHeight() const { return this->_height; }
+
+    /**
+     * @brief Gets the number of layers.
+     *
+     * @return int: The layer count.
+     */
+    inline int getLayerCount() const { return this->_layerCount; }
+
+    /**
+     * @brief Gets the memory held by the cells.
+     *
+     * @return size_t: Size of the cells in bytes.
+     */
+    inline size_t getMemorySize() const { return this->_gids.capacity() * sizeof(uint32_t); }
+
+private:
+    int _width; ///< Number of columns.
+    int _height; ///< Number of rows.
+    int _layerCount; ///< Number of layers.
+    std::vector<uint32_t> _gids; ///< Gids layer by layer, each layer row major.
+};
+
+#endif /* TILEGRID_H */
@@ -0,0 +1,116 @@
+/**
+ * @file tmxEncoding.h
+ * @brief Decoders and encoders for the tile data encodings a Tiled .tmx layer can use.
+ *
+ * Tiled can store a layer's gids as one <tile> element per cell (the legacy XML form), as CSV text,
+ * or as base64 text holding little endian 32 bit gids, optionally compressed with zlib, gzip or zstd.
+ * zstd support needs the zstd library and is only compiled in when HAVE_ZSTD is defined.
+ */
+
+#ifndef TMXENCODING_H
+#define TMXENCODING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @namespace tmxEncoding
+ * @brief Functions decoding the text of a <data> (or <chunk>) element into gids, and encoding gids back into it.
+ */
+namespace tmxEncoding{
+    /**
+     * @brief Decodes base64 text into bytes. Whitespace is skipped, decoding stops at the first '='.
+     *
+     * @param p_text The base64 text.
+     * @param p_bytes Filled with the decoded bytes.
+     * @return bool: False if the text has a character outside the base64 alphabet.
+     */
+    bool decodeBase64(const char* p_text, std::vector<unsigned char> &p_bytes);
+
+    /**
+     * @brief Parses comma separated gids.
+     *
+     * @param p_text The CSV text.
+     * @param p_gids Filled with the gids.
+     * @return bool: False if the text has anything but digits, commas and whitespace.
+     */
+    bool decodeCsv(const char* p_text, std::vector<uint32_t> &p_gids);
+
+    /**
+     * @brief Decompresses bytes of a known decompressed size.
+     *
+     * @param p_compression "zlib", "gzip" or "zstd".
+     * @param p_bytes The compressed bytes.
+     * @param p_size The decompressed size.
+     * @param p_output Filled with the decompressed bytes.
+     * @return bool: False on an unsupported compression or corrupt data.
+     */
+    bool decompress(const std::string &p_compression, const std::vector<unsigned char> &p_bytes,
+                    size_t p_size, std::vector<unsigned char> &p_output);
+
+    /**
+     * @brief Decodes the text of a <data> or <chunk> element holding a given number of cells.
+     *
+     * @param p_text The element's text.
+     * @param p_encoding The element's encoding attribute, "csv" or "base64".
+     * @param p_compression The element's compression attribute, empty when uncompressed.
+     * @param p_cellCount Number of cells the element covers.
+     * @param p_gids Filled with exactly p_cellCount gids.
+     * @return bool: False if the data can't be decoded or doesn't hold p_cellCount gids.
+     */
+    bool decodeGids(const char* p_text, const std::string &p_encoding, const std::string &p_compression,
+                    size_t p_cellCount, std::vector<uint32_t> &p_gids);
+
+    /**
+     * @brief Checks if a compression can be read and written by this build.
+     *
+     * @param p_compression "zlib", "gzip" or "zstd".
+     * @return bool: True for zlib and gzip, and for zstd when HAVE_ZSTD is defined.
+     */
+    bool isCompressionSupported(const std::string &p_compression);
+
+    /**
+     * @brief Encodes bytes as base64 text, padded with '='.
+     *
+     * @param p_bytes The bytes.
+     * @param p_text Filled with the base64 text.
+     */
+    void encodeBase64(const std::vector<unsigned char> &p_bytes, std::string &p_text);
+
+    /**
+     * @brief Writes gids as comma separated text, one row per line like Tiled does.
+     *
+     * @param p_gids The gids.
+     * @param p_width Number of gids per row.
+     * @param p_text Filled with the CSV text.
+     */
+    void encodeCsv(const std::vector<uint32_t> &p_gids, int p_width, std::string &p_text);
+
+    /**
+     * @brief Compresses bytes the way decompress() reads them back.
+     *
+     * @param p_compression "zlib", "gzip" or "zstd".
+     * @param p_bytes The bytes to compress.
+     * @param p_output Filled with the compressed bytes.
+     * @return bool: False on an unsupported compression.
+     */
+    bool compress(const std::string &p_compression, const std::vector<unsigned char> &p_bytes,
+                  std::vector<unsigned char> &p_output);
+
+    /**
+     * @brief Encodes gids into the text of a <data> or <chunk> element, the inverse of decodeGids().
+     *
+     * @param p_gids The gids.
+     * @param p_width Number of gids per row, used to break CSV text into lines.
+     * @param p_encoding "csv" or "base64".
+     * @param p_compression Compression of a base64 payload, empty for none.
+     * @param p_text Filled with the element's text.
+     * @return bool: False on an unknown encoding, an unsupported compression or a compressed CSV.
+     */
+    bool encodeGids(const std::vector<uint32_t> &p_gids, int p_width, const std::string &p_encoding,
+                    const std::string &p_compression, std::string &p_text);
+}
+
+#endif /* TMXENCODING_H */
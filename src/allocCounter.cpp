@@ -0,0 +1,46 @@
+#include <cstdlib>
+#include <new>
+
+#include "allocCounter.h"
+
+namespace{
+    //per thread, so the preloader and streaming workers do not show up in the main thread's counts
+    thread_local unsigned long long allocationCount = 0;
+
+    void* countedAlloc(std::size_t p_size){
+        allocationCount++;
+        void* ptr = std::malloc(p_size == 0 ? 1 : p_size);
+        if(ptr == NULL){
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+}
+
+unsigned long long allocCounter::getCount(){
+    return allocationCount;
+}
+
+void* operator new(std::size_t p_size){
+    return countedAlloc(p_size);
+}
+
+void* operator new[](std::size_t p_size){
+    return countedAlloc(p_size);
+}
+
+void operator delete(void* p_ptr) noexcept{
+    std::free(p_ptr);
+}
+
+void operator delete[](void* p_ptr) noexcept{
+    std::free(p_ptr);
+}
+
+void operator delete(void* p_ptr, std::size_t) noexcept{
+    std::free(p_ptr);
+}
+
+void operator delete[](void* p_ptr, std::size_t) noexcept{
+    std::free(p_ptr);
+}
@@ -28,7 +28,7 @@ void AnimatedSprite::playAnimation(std::string p_animation, bool p_once){
     }
 }
 
-void AnimatedSprite::update(int p_elapsedTime){
+void AnimatedSprite::update(float p_elapsedTime){
     Sprite::update();
 
     this->_timeElapsed += p_elapsedTime;
@@ -54,7 +54,7 @@ void AnimatedSprite::draw(Graphics &p_graphics, int p_x, int p_y){
         dst.h = this->_src.h * globals::SPRITE_SCALE;
 
         SDL_Rect src = this->_animations[this->_currentAnimation][this->_frameIndex];
-        p_graphics.blitSurface(this->_spriteSheet, &src, &dst);
+        p_graphics.blitSurface(this->_spriteSheet.get(), &src, &dst);
     }
 }
 
@@ -1,5 +1,6 @@
 #include "graphics.h"
 #include "animatedTile.h"
+#include "camera.h"
 #include <SDL2/SDL_rect.h>
 
 AnimatedTile::AnimatedTile(std::vector<Vector2f> p_tilesetPositions, int p_duration, 
@@ -11,7 +12,7 @@ AnimatedTile::AnimatedTile(std::vector<Vector2f> p_tilesetPositions, int p_durat
 {
 }
 
-void AnimatedTile::update(int p_elapsedTime){
+void AnimatedTile::update(float p_elapsedTime){
     if(this->_amountOfTime <= 0){
         if(this->_tileToDraw == this->_tilesetPositions.size() - 1){
             this->_tileToDraw = 0;
@@ -25,11 +26,11 @@ void AnimatedTile::update(int p_elapsedTime){
     Tile::update(p_elapsedTime);
 }
 
-void AnimatedTile::draw(Graphics &p_graphics){
+void AnimatedTile::draw(Graphics &p_graphics, const Camera &p_camera) const{
     SDL_Rect src = {this->_tilesetPositions[this->_tileToDraw].x, this->_tilesetPositions[this->_tileToDraw].y, 
     this->_size.x, this->_size.y};
 
-    SDL_Rect dst = {this->_position.x, this->_position.y, 
+    SDL_Rect dst = {p_camera.toScreenX(this->_position.x), p_camera.toScreenY(this->_position.y), 
     this->_size.x * globals::SPRITE_SCALE, this->_size.y * globals::SPRITE_SCALE};
     
     p_graphics.blitSurface(this->_tileset, &src, &dst);
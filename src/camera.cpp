@@ -0,0 +1,17 @@
+#include <algorithm>
+
+#include "camera.h"
+
+Camera::Camera():
+    _x(0),
+    _y(0)
+{}
+
+void Camera::follow(const Rectangle &p_target, Vector2f p_levelSize){
+    int x = p_target.getCenterX() - globals::SCREEN_WIDTH / 2;
+    int y = p_target.getTop() + p_target.getHeight() / 2 - globals::SCREEN_HEIGHT / 2;
+
+    //levels smaller than the screen stay at the origin, like before the camera existed
+    this->_x = std::max(0, std::min(x, p_levelSize.x - globals::SCREEN_WIDTH));
+    this->_y = std::max(0, std::min(y, p_levelSize.y - globals::SCREEN_HEIGHT));
+}
@@ -0,0 +1,262 @@
+#include <algorithm>
+#include <cstdio>
+
+#include "chunkStreamer.h"
+#include "levelCache.h"
+#include "graphics.h"
+#include "camera.h"
+
+namespace{
+    Rectangle growBy(const Rectangle &p_rect, int p_x, int p_y){
+        return Rectangle(p_rect.getLeft() - p_x, p_rect.getTop() - p_y,
+            p_rect.getWidth() + p_x * 2, p_rect.getHeight() + p_y * 2);
+    }
+
+    long long distanceSquared(const Rectangle &p_rect, Vector2f p_point){
+        long long dx = p_rect.getLeft() + p_rect.getWidth() / 2 - (int)p_point.x;
+        long long dy = p_rect.getTop() + p_rect.getHeight() / 2 - (int)p_point.y;
+        return dx * dx + dy * dy;
+    }
+}
+
+ChunkStreamer::ChunkStreamer(const std::shared_ptr<const LevelTemplate> &p_template, int p_radius):
+    _template(p_template),
+    _radius(std::max(p_radius, 1)),
+    _stopping(false)
+{
+    const MapData &map = *this->_template->Map;
+    int tileWidth = map.TileSize.x * globals::SPRITE_SCALE;
+    int tileHeight = map.TileSize.y * globals::SPRITE_SCALE;
+
+    //chunks are laid out on a regular grid in Tiled, so a chunk sized cell holds about one chunk per layer
+    Vector2f cellSize = Vector2f(16 * tileWidth, 16 * tileHeight);
+    for(int l = 0; l < map.Layers.size(); l++){
+        if(!map.Layers[l].Chunks.empty()){
+            cellSize = Vector2f(map.Layers[l].Chunks[0].Width * tileWidth, map.Layers[l].Chunks[0].Height * tileHeight);
+            break;
+        }
+    }
+    this->_chunkGrid = SpatialGrid(cellSize, Vector2f(map.Size.x * tileWidth, map.Size.y * tileHeight));
+
+    //the collision layer is never drawn, its solid cells are in the level's collision mask
+    for(int l = 0; l < map.Layers.size(); l++){
+        if(map.Layers[l].Collision){
+            continue;
+        }
+        for(int c = 0; c < map.Layers[l].Chunks.size(); c++){
+            const ChunkData &data = map.Layers[l].Chunks[c];
+            Chunk chunk;
+            chunk.Layer = l;
+            chunk.Index = c;
+            chunk.Bounds = Rectangle(data.X * tileWidth, data.Y * tileHeight, data.Width * tileWidth, data.Height * tileHeight);
+            chunk.Requested = false;
+            this->_chunkGrid.insert(chunk.Bounds);
+            this->_chunks.push_back(std::move(chunk));
+        }
+    }
+
+    for(int i = 0; i < this->_template->Tilesets.size(); i++){
+        this->_batches.push_back(TileBatch(this->_template->Tilesets[i].Texture.get()));
+    }
+
+    //the chunks on screen at the spawn point are loaded right away so the level doesn't start empty
+    Rectangle spawnView = Rectangle(map.SpawnPoint.x - globals::SCREEN_WIDTH / 2, map.SpawnPoint.y - globals::SCREEN_HEIGHT / 2,
+        globals::SCREEN_WIDTH, globals::SCREEN_HEIGHT);
+    this->_chunkGrid.query(spawnView, this->_queryIds);
+    for(int i = 0; i < this->_queryIds.size(); i++){
+        int id = this->_queryIds[i];
+        if(this->_chunks[id].Bounds.collidesWith(spawnView)){
+            this->_chunks[id].Tiles = this->loadChunk(id);
+            this->_residentIds.push_back(id);
+        }
+    }
+
+    this->_worker = std::thread(&ChunkStreamer::run, this);
+}
+
+ChunkStreamer::~ChunkStreamer(){
+    {
+        std::lock_guard<std::mutex> lock(this->_mutex);
+        this->_stopping = true;
+    }
+    this->_wakeUp.notify_one();
+    this->_worker.join();
+}
+
+void ChunkStreamer::update(const Rectangle &p_focus, float p_elapsedTime){
+    Rectangle keep = growBy(p_focus, globals::SCREEN_WIDTH * this->_radius, globals::SCREEN_HEIGHT * this->_radius);
+    Rectangle drop = growBy(keep, globals::SCREEN_WIDTH, globals::SCREEN_HEIGHT);
+
+    std::vector<std::pair<int, std::unique_ptr<ChunkTiles>>> finished;
+    std::vector<std::unique_ptr<ChunkTiles>> dropped;
+    {
+        std::lock_guard<std::mutex> lock(this->_mutex);
+        finished.swap(this->_finished);
+
+        //queued chunks the focus moved away from are no longer worth decoding
+        for(std::deque<int>::iterator it = this->_requests.begin(); it != this->_requests.end();){
+            if(!this->_chunks[*it].Bounds.collidesWith(drop)){
+                this->_chunks[*it].Requested = false;
+                it = this->_requests.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    for(int i = 0; i < finished.size(); i++){
+        Chunk &chunk = this->_chunks[finished[i].first];
+        chunk.Requested = false;
+        if(chunk.Bounds.collidesWith(drop)){
+            chunk.Tiles = std::move(finished[i].second);
+            this->_residentIds.push_back(finished[i].first);
+        } else {
+            dropped.push_back(std::move(finished[i].second));
+        }
+    }
+
+    for(int i = this->_residentIds.size() - 1; i >= 0; i--){
+        Chunk &chunk = this->_chunks[this->_residentIds[i]];
+        if(!chunk.Bounds.collidesWith(drop)){
+            dropped.push_back(std::move(chunk.Tiles));
+            this->_residentIds.erase(this->_residentIds.begin() + i);
+        }
+    }
+
+    //nearest chunks first, so the ones about to be seen are ready before the far ones
+    std::vector<int> requests;
+    this->_queryIds.clear();
+    this->_chunkGrid.query(keep, this->_queryIds);
+    for(int i = 0; i < this->_queryIds.size(); i++){
+        Chunk &chunk = this->_chunks[this->_queryIds[i]];
+        if(!chunk.Tiles && !chunk.Requested && chunk.Bounds.collidesWith(keep)){
+            chunk.Requested = true;
+            requests.push_back(this->_queryIds[i]);
+        }
+    }
+    Vector2f focus = Vector2f(p_focus.getLeft() + p_focus.getWidth() / 2, p_focus.getTop() + p_focus.getHeight() / 2);
+    std::sort(requests.begin(), requests.end(), [this, focus](int p_a, int p_b){
+        return distanceSquared(this->_chunks[p_a].Bounds, focus) < distanceSquared(this->_chunks[p_b].Bounds, focus);
+    });
+
+    if(!requests.empty() || !dropped.empty()){
+        {
+            std::lock_guard<std::mutex> lock(this->_mutex);
+            this->_requests.insert(this->_requests.end(), requests.begin(), requests.end());
+            for(int i = 0; i < dropped.size(); i++){
+                this->_dropped.push_back(std::move(dropped[i]));
+            }
+        }
+        this->_wakeUp.notify_one();
+    }
+
+    for(int i = 0; i < this->_residentIds.size(); i++){
+        std::vector<AnimatedTile> &animatedTiles = this->_chunks[this->_residentIds[i]].Tiles->AnimatedTiles;
+        for(int t = 0; t < animatedTiles.size(); t++){
+            animatedTiles[t].update(p_elapsedTime);
+        }
+    }
+}
+
+void ChunkStreamer::draw(Graphics &p_graphics, const Camera &p_camera){
+    Rectangle view = p_camera.getView();
+    this->_queryIds.clear();
+    this->_chunkGrid.query(view, this->_queryIds);
+
+    auto flush = [this, &p_graphics](){
+        for(int b = 0; b < this->_batches.size(); b++){
+            if(this->_batches[b].getTileCount() > 0){
+                this->_batches[b].draw(p_graphics);
+                this->_batches[b].clear();
+            }
+        }
+    };
+    auto addTile = [this, &p_camera](SDL_Texture* p_texture, Vector2f p_source, Vector2f p_size, Vector2f p_position){
+        for(int b = 0; b < this->_batches.size(); b++){
+            if(this->_batches[b].getTexture() == p_texture){
+                this->_batches[b].addTile(p_source, p_size,
+                    Vector2f(p_camera.toScreenX(p_position.x), p_camera.toScreenY(p_position.y)));
+                return;
+            }
+        }
+    };
+
+    //ids ascend layer by layer, so the query order is the draw order; batches are flushed between layers
+    int layer = -1;
+    for(int i = 0; i < this->_queryIds.size(); i++){
+        const Chunk &chunk = this->_chunks[this->_queryIds[i]];
+        if(!chunk.Tiles || !chunk.Bounds.collidesWith(view)){
+            continue;
+        }
+        if(chunk.Layer != layer){
+            flush();
+            layer = chunk.Layer;
+        }
+        const std::vector<Tile> &tiles = chunk.Tiles->Tiles;
+        for(int t = 0; t < tiles.size(); t++){
+            addTile(tiles[t].getTileset(), tiles[t].getTilesetPosition(), tiles[t].getSize(), tiles[t].getPosition());
+        }
+    }
+    flush();
+
+    //animated tiles go on top of every static layer, like in a fully loaded level
+    for(int i = 0; i < this->_queryIds.size(); i++){
+        const Chunk &chunk = this->_chunks[this->_queryIds[i]];
+        if(!chunk.Tiles || !chunk.Bounds.collidesWith(view)){
+            continue;
+        }
+        const std::vector<AnimatedTile> &animatedTiles = chunk.Tiles->AnimatedTiles;
+        for(int t = 0; t < animatedTiles.size(); t++){
+            addTile(animatedTiles[t].getTileset(), animatedTiles[t].getCurrentTilesetPosition(),
+                animatedTiles[t].getSize(), animatedTiles[t].getPosition());
+        }
+    }
+    flush();
+}
+
+void ChunkStreamer::run(){
+    while(true){
+        int id = -1;
+        std::vector<std::unique_ptr<ChunkTiles>> dropped;
+        {
+            std::unique_lock<std::mutex> lock(this->_mutex);
+            this->_wakeUp.wait(lock, [this](){
+                return this->_stopping || !this->_requests.empty() || !this->_dropped.empty();
+            });
+            if(this->_stopping){
+                return;
+            }
+            dropped.swap(this->_dropped);
+            if(!this->_requests.empty()){
+                id = this->_requests.front();
+                this->_requests.pop_front();
+            }
+        }
+
+        //the dropped tiles are freed here, off the main thread
+        dropped.clear();
+
+        if(id != -1){
+            std::unique_ptr<ChunkTiles> tiles = this->loadChunk(id);
+            std::lock_guard<std::mutex> lock(this->_mutex);
+            this->_finished.push_back(std::make_pair(id, std::move(tiles)));
+        }
+    }
+}
+
+std::unique_ptr<ChunkStreamer::ChunkTiles> ChunkStreamer::loadChunk(int p_id) const {
+    const MapData &map = *this->_template->Map;
+    const ChunkData &data = map.Layers[this->_chunks[p_id].Layer].Chunks[this->_chunks[p_id].Index];
+    std::unique_ptr<ChunkTiles> tiles(new ChunkTiles());
+
+    std::vector<uint32_t> gids;
+    if(!MapData::decodeChunk(data, gids)){
+        printf("\nError: Unable to decode a chunk at %d, %d\n", data.X, data.Y);
+        return tiles;
+    }
+    for(int i = 0; i < gids.size(); i++){
+        Vector2f position = Vector2f((data.X + i % data.Width) * map.TileSize.x, (data.Y + i / data.Width) * map.TileSize.y);
+        this->_template->appendTile(gids[i], position, tiles->Tiles, tiles->AnimatedTiles);
+    }
+    return tiles;
+}
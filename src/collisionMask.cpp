@@ -0,0 +1,26 @@
+#include <algorithm>
+
+#include "collisionMask.h"
+
+CollisionMask::CollisionMask():
+    _width(0),
+    _height(0),
+    _wordsPerRow(0)
+{}
+
+CollisionMask::CollisionMask(int p_width, int p_height):
+    _width(std::max(p_width, 0)),
+    _height(std::max(p_height, 0))
+{
+    this->_wordsPerRow = (this->_width + 63) / 64;
+    this->_words.assign((size_t)this->_wordsPerRow * this->_height, 0);
+}
+
+void CollisionMask::setSolid(int p_x, int p_y, bool p_solid){
+    if(p_x < 0 || p_y < 0 || p_x >= this->_width || p_y >= this->_height){
+        return;
+    }
+    uint64_t &word = this->_words[(size_t)p_y * this->_wordsPerRow + (p_x >> 6)];
+    uint64_t bit = (uint64_t)1 << (p_x & 63);
+    word = p_solid ? word | bit : word & ~bit;
+}
@@ -1,4 +1,5 @@
 #include "enemy.h"
+#include "camera.h"
 
 Enemy::Enemy(){}
 
@@ -14,7 +15,7 @@ Enemy::Enemy(Graphics &p_graphics, std::string p_filePath, int p_sourceX, int p_
             _invincibilityTimer(0)
         {}
 
-void Enemy::update(int p_elapsedTime, Player &p_player){
+void Enemy::update(float p_elapsedTime, Player &p_player){
     // update invinc timer
     if(this->_isInvicible){
         this->_invincibilityTimer -= p_elapsedTime;
@@ -26,8 +27,9 @@ void Enemy::update(int p_elapsedTime, Player &p_player){
     AnimatedSprite::update(p_elapsedTime);
 }
 
-void Enemy::draw(Graphics &p_graphics){
-    AnimatedSprite::draw(p_graphics, this->_x, this->_y);
+void Enemy::draw(Graphics &p_graphics, const Camera &p_camera, float p_alpha){
+    AnimatedSprite::draw(p_graphics, p_camera.toScreenX(this->getInterpolatedX(p_alpha)),
+        p_camera.toScreenY(this->getInterpolatedY(p_alpha)));
 }
 
 void Enemy::touchPlayer(Player* p_player){
@@ -50,7 +52,7 @@ Bat::Bat(Graphics &p_graphics, Vector2f p_spawnPoint):
         this->playAnimation("FlyLeft");
     }
 
-void Bat::update(int p_elapsedTime, Player &p_player){
+void Bat::update(float p_elapsedTime, Player &p_player){
     this->_direction = p_player.getX() > this->_x ? RIGHT : LEFT;
     this->playAnimation(this->_direction == RIGHT ? "FlyRight" : "FlyLeft");
 
@@ -63,8 +65,8 @@ void Bat::update(int p_elapsedTime, Player &p_player){
     Enemy::update(p_elapsedTime, p_player);
 }
 
-void Bat::draw(Graphics &p_graphics){
-    Enemy::draw(p_graphics);
+void Bat::draw(Graphics &p_graphics, const Camera &p_camera, float p_alpha){
+    Enemy::draw(p_graphics, p_camera, p_alpha);
 }
 
 void Bat::touchPlayer(Player* p_player){
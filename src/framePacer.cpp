@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <cmath>
+
+#include "framePacer.h"
+
+namespace{
+    const float SPIN_MARGIN_MS = 1.0f; // below this the pacer yields instead of sleeping, as SDL_Delay(1) may oversleep
+}
+
+FramePacer::FramePacer():
+    FramePacer(pacing::UNCAPPED, 0)
+{}
+
+FramePacer::FramePacer(pacing::Mode p_mode, int p_targetFps):
+    _mode(p_mode),
+    _frequency(SDL_GetPerformanceFrequency()),
+    _frameDuration(0),
+    _lastFrameTime(0),
+    _frameCount(0)
+{
+    if(this->_mode == pacing::LIMITED && p_targetFps > 0){
+        this->_frameDuration = this->_frequency / p_targetFps;
+    } else if(this->_mode == pacing::LIMITED){
+        this->_mode = pacing::UNCAPPED;
+    }
+    this->_lastFrameEnd = SDL_GetPerformanceCounter();
+    this->_deadline = this->_lastFrameEnd + this->_frameDuration;
+}
+
+void FramePacer::endFrame(){
+    if(this->_mode == pacing::LIMITED){
+        Uint64 now = SDL_GetPerformanceCounter();
+        if(now < this->_deadline){
+            //short sleeps, rechecking the clock after each, so an oversleep costs at most one of them
+            float remaining = (this->_deadline - now) * 1000.0f / this->_frequency;
+            while(remaining > SPIN_MARGIN_MS){
+                SDL_Delay(1);
+                now = SDL_GetPerformanceCounter();
+                remaining = now < this->_deadline ? (this->_deadline - now) * 1000.0f / this->_frequency : 0.0f;
+            }
+            while(SDL_GetPerformanceCounter() < this->_deadline){
+                SDL_Delay(0);
+            }
+            this->_deadline += this->_frameDuration;
+        } else {
+            //too late for this deadline: start over from now instead of rushing frames to catch up
+            this->_deadline = now + this->_frameDuration;
+        }
+    }
+
+    Uint64 frameEnd = SDL_GetPerformanceCounter();
+    this->_lastFrameTime = (frameEnd - this->_lastFrameEnd) * 1000.0f / this->_frequency;
+    this->_lastFrameEnd = frameEnd;
+
+    this->_frameTimes[this->_frameCount % WINDOW_SIZE] = this->_lastFrameTime;
+    this->_frameCount++;
+}
+
+float FramePacer::getAverageFrameTime() const{
+    int count = std::min(this->_frameCount, WINDOW_SIZE);
+    if(count == 0){
+        return 0.0f;
+    }
+    float total = 0.0f;
+    for(int i = 0; i < count; i++){
+        total += this->_frameTimes[i];
+    }
+    return total / count;
+}
+
+float FramePacer::getJitter() const{
+    int count = std::min(this->_frameCount, WINDOW_SIZE);
+    if(count == 0){
+        return 0.0f;
+    }
+    float average = this->getAverageFrameTime();
+    float variance = 0.0f;
+    for(int i = 0; i < count; i++){
+        variance += (this->_frameTimes[i] - average) * (this->_frameTimes[i] - average);
+    }
+    return std::sqrt(variance / count);
+}
+
+const char* FramePacer::getModeName(pacing::Mode p_mode){
+    return
+            p_mode == pacing::VSYNC ? "vsync" :
+            p_mode == pacing::LIMITED ? "limited" :
+            "uncapped";
+}
@@ -1,19 +1,71 @@
 #include <SDL2/SDL.h>
+#include <algorithm>
 #include <iostream>
 
 #include "game.h"
 #include "graphics.h"
 #include "input.h"
 #include "hud.h"
+#include "allocCounter.h"
+#include "profiler.h"
 
 namespace{
-    const int FPS = 50;
-    const int MAX_FRAME_TIME = 1000 / FPS;
+    const float MAX_FRAME_TIME = 250.0f; // longest real time simulated in one frame, in ms
+#ifdef ENABLE_PROFILER
+    const char* PROFILE_PATH = "profile.json"; // written when the game quits, F9 writes profile_<frame>.json
+#endif
 }
 
-Game::Game(){
-    SDL_Init(SDL_INIT_EVERYTHING);
-    this->gameLoop();
+Game::Game(const GameOptions &p_options):
+    _options(p_options),
+    _tickDuration(1000.0f / std::max(p_options.TickRate, 1)),
+    _renderTime(0.0f),
+    _collisionAllocations(0),
+    _totalCollisionAllocations(0),
+    _ticks(0),
+    _failed(false)
+{
+    //a replay runs at the tick rate it was recorded at, or the same keys would lead somewhere else
+    if(!this->_options.ReplayPath.empty()){
+        if(!this->_recording.load(this->_options.ReplayPath)){
+            this->_failed = true;
+            return;
+        }
+        if(this->_recording.getTickRate() != this->_options.TickRate){
+            std::cout << "Replaying at the recorded tick rate of " << this->_recording.getTickRate() << std::endl;
+            this->_tickDuration = 1000.0f / std::max(this->_recording.getTickRate(), 1);
+        }
+    } else if(!this->_options.RecordPath.empty()){
+        this->_recording.setTickRate(this->_options.TickRate);
+    }
+
+    if(this->_options.Headless){
+        //the dummy driver needs no display, windows and events exist only in memory
+        SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+        SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER);
+        this->simulate();
+    } else {
+        SDL_Init(SDL_INIT_EVERYTHING);
+        this->gameLoop();
+    }
+
+#ifdef ENABLE_PROFILER
+    if(profiler::dump(PROFILE_PATH)){
+        std::cout << "Wrote the last frames' profile to " << PROFILE_PATH << std::endl;
+    }
+#endif
+
+    std::cout << "Collision pass: " << this->_totalCollisionAllocations << " heap allocations over "
+              << this->_ticks << " ticks (" << this->_collisionAllocations << " in the last tick)" << std::endl;
+
+    if(this->_options.ReplayPath.empty() && !this->_options.RecordPath.empty()){
+        if(this->_recording.save(this->_options.RecordPath)){
+            std::cout << "Recorded " << this->_recording.getTickCount() << " ticks of input to "
+                      << this->_options.RecordPath << std::endl;
+        } else {
+            this->_failed = true;
+        }
+    }
 }
 
 Game::~Game(){
@@ -21,111 +73,277 @@ Game::~Game(){
 }
 
 void Game::gameLoop(){
-    Graphics graphics;
+    Graphics graphics(this->_options.Pacing == pacing::VSYNC);
     Input input;
     SDL_Event e;
 
-    this->_level = Level("Map 1", graphics);
-    this->_player = Player(graphics, this->_level.getPlayerSpawnPoint());
-    this->_hud = Hud(graphics, this->_player);
+    //without vsync support, fall back to sleeping until each frame's deadline instead of spinning
+    pacing::Mode pacingMode = this->_options.Pacing;
+    if(pacingMode == pacing::VSYNC && !graphics.isVsyncEnabled()){
+        std::cout << "Vsync unavailable, limiting to " << this->_options.TargetFps << " FPS instead" << std::endl;
+        pacingMode = pacing::LIMITED;
+    }
+    FramePacer pacer(pacingMode, this->_options.TargetFps);
 
-    int LAST_UPDATE_TIME = SDL_GetTicks64();
+    this->start(graphics);
 
-    while(true){
-        input.beginNewFrame();
+    const Uint64 COUNTER_FREQUENCY = SDL_GetPerformanceFrequency();
+    Uint64 lastFrameCounter = SDL_GetPerformanceCounter();
+    float accumulator = 0.0f;
 
-        if(SDL_PollEvent(&e)){
-            if(e.type == SDL_KEYDOWN){
-                if(e.key.repeat == 0){
-                    input.keyDownEvent(e);
+    bool running = true;
+    while(running){
+        //drain every pending event so bursts don't pile up in the queue and add latency
+        {
+            PROFILE_ZONE("Input");
+            while(SDL_PollEvent(&e)){
+                if(e.type == SDL_KEYDOWN){
+                    if(e.key.repeat == 0){
+                        input.keyDownEvent(e);
+                        //interface keys act once per press, key edges only clear when a tick runs
+                        if(e.key.keysym.scancode == SDL_SCANCODE_F3){
+                            this->_hud.setPerfOverlayVisible(!this->_hud.isPerfOverlayVisible());
+                        }
+#ifdef ENABLE_PROFILER
+                        if(e.key.keysym.scancode == SDL_SCANCODE_F9){
+                            std::string profilePath = "profile_" + std::to_string(profiler::getFrameCount()) + ".json";
+                            if(profiler::dump(profilePath)){
+                                std::cout << "Wrote the last frames' profile to " << profilePath << std::endl;
+                            }
+                        }
+#endif
+                    }
+                } else if(e.type == SDL_KEYUP){
+                    input.keyUpEvent(e);
+                } else if(e.type == SDL_RENDER_TARGETS_RESET || e.type == SDL_RENDER_DEVICE_RESET){
+                    this->_level.invalidateTileCache();
+                } else if(e.type == SDL_QUIT){
+                    running = false;
                 }
-            } else if(e.type == SDL_KEYUP){
-                input.keyUpEvent(e);
-            } else if(e.type == SDL_QUIT){
-                return;
             }
         }
-        if(input.wasKeyPressed(SDL_SCANCODE_ESCAPE)){
-            return;
+        if(!running){
+            break;
         }
-        else if(input.isKeyHeld(SDL_SCANCODE_LEFT) == true){
-            this->_player.moveLeft();
-        }
-        else if(input.isKeyHeld(SDL_SCANCODE_RIGHT) == true){
-            this->_player.moveRight();
+        if(input.wasKeyPressed(SDL_SCANCODE_ESCAPE)){
+            break;
         }
 
-        if(input.isKeyHeld(SDL_SCANCODE_UP) == true){
-            this->_player.lookUp();
+        //run as many fixed ticks as the real time elapsed allows, the remainder carries over to the next frame
+        const Uint64 currentCounter = SDL_GetPerformanceCounter();
+        float frameTime = (currentCounter - lastFrameCounter) * 1000.0f / COUNTER_FREQUENCY;
+        lastFrameCounter = currentCounter;
+        accumulator += std::min(frameTime, MAX_FRAME_TIME);
+
+        while(accumulator >= this->_tickDuration && !this->isFinished()){
+            this->tick(input, graphics);
+            accumulator -= this->_tickDuration;
         }
-        else if(input.isKeyHeld(SDL_SCANCODE_DOWN) == true){
-            this->_player.lookDown();
+        if(this->isFinished()){
+            break;
         }
 
-        if(input.wasKeyReleased(SDL_SCANCODE_UP) == true){
-            this->_player.stopLookingUp();
+        //the draw statistics are the previous frame's, this one isn't drawn yet
+        PerfStats stats;
+        stats.FrameTime = frameTime;
+        stats.UpdateTime = (SDL_GetPerformanceCounter() - currentCounter) * 1000.0f / COUNTER_FREQUENCY;
+        stats.RenderTime = this->_renderTime;
+        stats.DrawCalls = graphics.getDrawCalls();
+        stats.TextureBinds = graphics.getTextureBinds();
+        stats.CollisionTests = this->_level.getCollisionTests();
+        stats.Entities = this->_level.getEnemyCount() + 1;
+        this->_hud.setPerfStats(stats);
+        this->_level.resetCollisionTests();
+
+        //queue the doors of a level just entered, and pick up whatever finished loading meanwhile
+        if(this->_level.getMapName() != this->_preloadedMap){
+            this->preloadDoorDestinations();
         }
-        if(input.wasKeyReleased(SDL_SCANCODE_DOWN) == true){
-            this->_player.stopLookingDown();
+        this->_levelPreloader.poll(this->_levelCache, graphics);
+
+        this->draw(graphics, accumulator / this->_tickDuration);
+        {
+            PROFILE_ZONE("FramePacer::endFrame");
+            pacer.endFrame();
         }
-        if(input.wasKeyPressed(SDL_SCANCODE_SPACE) || input.isKeyHeld(SDL_SCANCODE_SPACE)){
-            this->_player.jump();
+        PROFILE_FRAME();
+    }
+
+    std::cout << "Frame time (" << FramePacer::getModeName(pacer.getMode()) << "): "
+              << pacer.getAverageFrameTime() << " ms average, " << pacer.getJitter() << " ms jitter" << std::endl;
+}
+
+void Game::simulate(){
+    Graphics graphics(false, true);
+    Input input;
+    SDL_Event e;
+
+    this->start(graphics);
+
+    const Uint64 COUNTER_FREQUENCY = SDL_GetPerformanceFrequency();
+    const Uint64 startCounter = SDL_GetPerformanceCounter();
+
+    //ticks follow each other without waiting on real time, a session lasts only as long as its updates
+    bool running = true;
+    while(running && !this->isFinished()){
+        //without a window the only events are quit requests, such as SIGINT or SIGTERM
+        while(SDL_PollEvent(&e)){
+            if(e.type == SDL_QUIT){
+                running = false;
+            }
         }
+        this->tick(input, graphics);
+        PROFILE_FRAME();
+    }
+
+    float seconds = (SDL_GetPerformanceCounter() - startCounter) / (float)COUNTER_FREQUENCY;
+    std::cout << "Simulated " << this->_ticks << " ticks (" << this->_ticks * this->_tickDuration / 1000.0f
+              << " s of game time) in " << seconds << " s, " << (seconds > 0.0f ? this->_ticks / seconds : 0.0f)
+              << " ticks per second" << std::endl;
+    std::cout << "Player ended in " << this->_level.getMapName() << " at " << this->_player.getX() << ", "
+              << this->_player.getY() << " with " << this->_player.getCurrentHealth() << "/"
+              << this->_player.getMaxHealth() << " health" << std::endl;
+}
 
-        if(!input.isKeyHeld(SDL_SCANCODE_LEFT) && !input.isKeyHeld(SDL_SCANCODE_RIGHT)){
-            this->_player.stopMoving();
+void Game::start(Graphics &p_graphics){
+    this->_levelCache.setStreamingRadius(this->_options.StreamRadius);
+    this->_levelCache.setTileDrawMode(this->_options.TileDrawMode);
+    this->_level = this->_levelCache.createLevel(this->_options.StartMap, p_graphics);
+    this->_player = Player(p_graphics, this->_level.getPlayerSpawnPoint());
+    this->_hud = Hud(p_graphics, this->_player);
+    this->_hud.setPerfOverlayVisible(this->_options.PerfOverlay);
+}
+
+void Game::tick(Input &p_input, Graphics &p_graphics){
+    if(!this->_options.ReplayPath.empty()){
+        this->_recording.replay(this->_replayInput);
+        this->handleInput(this->_replayInput);
+    } else {
+        if(!this->_options.RecordPath.empty()){
+            this->_recording.record(p_input);
         }
+        this->handleInput(p_input);
+    }
+    this->update(this->_tickDuration, p_graphics);
 
-        const int CURRENT_TIME_MS = SDL_GetTicks64();
-        int ELAPSED_TIME_MS = CURRENT_TIME_MS - LAST_UPDATE_TIME;
+    //each key event reaches exactly one tick, whether a frame runs several ticks or none
+    p_input.beginNewFrame();
+}
 
-        this->_graphics = graphics;
-        this->update(std::min(ELAPSED_TIME_MS, MAX_FRAME_TIME), graphics);
-        LAST_UPDATE_TIME = CURRENT_TIME_MS;
+void Game::handleInput(const Input &p_input){
+    PROFILE_ZONE("Game::handleInput");
+    if(p_input.isKeyHeld(SDL_SCANCODE_LEFT) == true){
+        this->_player.moveLeft();
+    }
+    else if(p_input.isKeyHeld(SDL_SCANCODE_RIGHT) == true){
+        this->_player.moveRight();
+    }
 
-        this->draw(graphics);
+    if(p_input.isKeyHeld(SDL_SCANCODE_UP) == true){
+        this->_player.lookUp();
+    }
+    else if(p_input.isKeyHeld(SDL_SCANCODE_DOWN) == true){
+        this->_player.lookDown();
+    }
+
+    if(p_input.wasKeyReleased(SDL_SCANCODE_UP) == true){
+        this->_player.stopLookingUp();
+    }
+    if(p_input.wasKeyReleased(SDL_SCANCODE_DOWN) == true){
+        this->_player.stopLookingDown();
+    }
+    if(p_input.wasKeyPressed(SDL_SCANCODE_SPACE) || p_input.isKeyHeld(SDL_SCANCODE_SPACE)){
+        this->_player.jump();
+    }
+
+    if(!p_input.isKeyHeld(SDL_SCANCODE_LEFT) && !p_input.isKeyHeld(SDL_SCANCODE_RIGHT)){
+        this->_player.stopMoving();
     }
 }
 
-void Game::draw(Graphics &p_graphics){
+void Game::draw(Graphics &p_graphics, float p_alpha){
+    PROFILE_ZONE("Game::draw");
+    const Uint64 startCounter = SDL_GetPerformanceCounter();
     p_graphics.clear();
 
-    this->_level.draw(p_graphics);
-    this->_player.draw(p_graphics);
+    Rectangle playerBox = this->_player.getBoundingBox();
+    this->_camera.follow(Rectangle(this->_player.getInterpolatedX(p_alpha), this->_player.getInterpolatedY(p_alpha),
+        playerBox.getWidth(), playerBox.getHeight()), this->_level.getPixelSize());
+
+    this->_level.draw(p_graphics, this->_camera, p_alpha);
+    this->_player.draw(p_graphics, this->_camera, p_alpha);
     this->_hud.draw(p_graphics);
 
+    //presenting can wait on vsync, which isn't time spent rendering
+    this->_renderTime = (SDL_GetPerformanceCounter() - startCounter) * 1000.0f / SDL_GetPerformanceFrequency();
     p_graphics.flip();
 }
 
+void Game::preloadDoorDestinations(){
+    const std::vector<Door> &doors = this->_level.getDoors();
+    for(int i = 0; i < doors.size(); i++){
+        if(!this->_levelCache.contains(doors[i].getDestination())){
+            this->_levelPreloader.request(doors[i].getDestination());
+        }
+    }
+    this->_preloadedMap = this->_level.getMapName();
+}
+
 void Game::update(float p_elapsedTime, Graphics &p_graphics){
-    this->_player.update(p_elapsedTime);
-    this->_level.update(p_elapsedTime, this->_player, p_graphics);
+    PROFILE_ZONE("Game::update");
+    this->_player.savePreviousPosition();
+    this->_player.update(p_elapsedTime, this->_level);
+    this->_level.update(p_elapsedTime, this->_player);
+    this->_player.resetLevelOnDeath(this->_level, this->_levelCache, p_graphics);
     this->_hud.update(p_elapsedTime, this->_player);
 
-    std::vector<Rectangle> others;
-    if((others = this->_level.checkTileCollisions(this->_player.getBoundingBox())).size() > 0){
-        //player collided with at least one tile
-        this->_player.handleTileCollisions(others);
+    //the hit buffers are members so this pass reuses their capacity instead of allocating every frame
+    unsigned long long allocationsBefore = allocCounter::getCount();
+
+    //the player's move was swept against the tiles, this only catches a box that started inside one
+    {
+        PROFILE_ZONE("Collisions: tiles");
+        this->_level.checkTileCollisions(this->_player.getBoundingBox(), this->_tileHits);
+        if(this->_tileHits.size() > 0){
+            //player collided with at least one tile
+            this->_player.handleTileCollisions(this->_tileHits);
+        }
     }
 
-    std::vector<Object> o_others;
-    if((o_others = this->_level.checkObjectCollisions(this->_player.getBoundingBox())).size() > 0){
-        //player collided with at least one tile
-        this->_player.handleObjectCollisions(o_others);
+    {
+        PROFILE_ZONE("Collisions: objects");
+        this->_level.checkObjectCollisions(this->_player.getBoundingBox(), this->_objectHits);
+        if(this->_objectHits.size() > 0){
+            //player collided with at least one tile
+            this->_player.handleObjectCollisions(this->_objectHits);
+        }
     }
 
-    std::vector<Slope> s_others;
-    if((s_others = this->_level.checkSlopeCollisions(this->_player.getBoundingBox())).size() > 0){
-        this->_player.handleSlopeCollisions(s_others);
+    {
+        PROFILE_ZONE("Collisions: slopes");
+        this->_level.checkSlopeCollisions(this->_player.getBoundingBox(), this->_slopeHits);
+        if(this->_slopeHits.size() > 0){
+            this->_player.handleSlopeCollisions(this->_slopeHits);
+        }
     }
 
-    std::vector<Door> d_others;
-    if((d_others = this->_level.checkDoorCollisions(this->_player.getBoundingBox())).size() > 0){
-        this->_player.handleDoorCollision(d_others, this->_level, this->_graphics);
+    {
+        PROFILE_ZONE("Collisions: doors");
+        this->_level.checkDoorCollisions(this->_player.getBoundingBox(), this->_doorHits);
+        if(this->_doorHits.size() > 0){
+            this->_player.handleDoorCollision(this->_doorHits, this->_level, this->_levelCache, p_graphics);
+        }
     }
 
-    std::vector<Enemy*> e_others;
-    if((e_others = this->_level.checkEnemyCollisions(this->_player.getBoundingBox())).size() > 0){
-        this->_player.handleEnemyCollision(e_others);
+    {
+        PROFILE_ZONE("Collisions: enemies");
+        this->_level.checkEnemyCollisions(this->_player.getBoundingBox(), this->_enemyHits);
+        if(this->_enemyHits.size() > 0){
+            this->_player.handleEnemyCollision(this->_enemyHits);
+        }
     }
+
+    this->_collisionAllocations = allocCounter::getCount() - allocationsBefore;
+    this->_totalCollisionAllocations += this->_collisionAllocations;
+    this->_ticks++;
 }
\ No newline at end of file
@@ -1,15 +1,34 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
+#include <cstdio>
 
 #include "graphics.h"
 #include "globals.h"
+#include "profiler.h"
 
-Graphics::Graphics(){
-    SDL_CreateWindowAndRenderer(globals::SCREEN_WIDTH, globals::SCREEN_HEIGHT, 0, &this->_window, &this->_renderer);
+Graphics::Graphics(bool p_vsync, bool p_headless):
+    _rendererAlive(std::make_shared<bool>(true)),
+    _headless(p_headless),
+    _boundTexture(NULL),
+    _drawCalls(0),
+    _textureBinds(0),
+    _frameDrawCalls(0),
+    _frameTextureBinds(0)
+{
+    //a headless window is never shown, and the software renderer needs no GPU or display
+    this->_window = SDL_CreateWindow("", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+        globals::SCREEN_WIDTH, globals::SCREEN_HEIGHT, p_headless ? SDL_WINDOW_HIDDEN : 0);
+    if(this->_window == NULL){
+        printf("\nError: Unable to create the window: %s\n", SDL_GetError());
+    }
+    Uint32 flags = p_headless ? SDL_RENDERER_SOFTWARE : (p_vsync ? SDL_RENDERER_PRESENTVSYNC : 0);
+    this->_renderer = SDL_CreateRenderer(this->_window, -1, flags);
     SDL_SetWindowTitle(this->_window, "Cavestory");
 }
 
 Graphics::~Graphics(){
+    //SDL_DestroyRenderer frees every texture it owns, including cached ones still referenced elsewhere
+    *this->_rendererAlive = false;
     SDL_DestroyWindow(this->_window);
     SDL_DestroyRenderer(this->_renderer);
 }
@@ -21,12 +40,95 @@ SDL_Surface* Graphics::loadImage(const std::string &p_filePath){
     return this->_spriteSheets[p_filePath];
 }
 
+std::shared_ptr<SDL_Texture> Graphics::loadTexture(const std::string &p_filePath){
+    std::shared_ptr<SDL_Texture> texture = this->_textures[p_filePath].lock();
+    if(texture){
+        return texture;
+    }
+
+    SDL_Surface* surface = this->loadImage(p_filePath);
+    if(surface == NULL){
+        return texture;
+    }
+    this->_spriteSheets.erase(p_filePath);
+    return this->uploadTexture(p_filePath, surface);
+}
+
+std::shared_ptr<SDL_Texture> Graphics::uploadTexture(const std::string &p_filePath, SDL_Surface* p_surface){
+    std::shared_ptr<SDL_Texture> texture = this->_textures[p_filePath].lock();
+    if(!texture && p_surface != NULL){
+        texture = this->makeSharedTexture(SDL_CreateTextureFromSurface(this->_renderer, p_surface));
+        this->_textures[p_filePath] = texture;
+    }
+
+    //the pixels live on the GPU now, the CPU copy is no longer needed
+    if(p_surface != NULL){
+        SDL_FreeSurface(p_surface);
+    }
+    return texture;
+}
+
+std::shared_ptr<SDL_Texture> Graphics::createTargetTexture(int p_width, int p_height){
+    SDL_Texture* texture = SDL_CreateTexture(this->_renderer, SDL_PIXELFORMAT_RGBA8888,
+        SDL_TEXTUREACCESS_TARGET, p_width, p_height);
+    if(texture == NULL){
+        printf("\nError: Unable to create render target: %s\n", SDL_GetError());
+        return std::shared_ptr<SDL_Texture>();
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    return this->makeSharedTexture(texture);
+}
+
+bool Graphics::supportsRenderTargets() const{
+    return SDL_RenderTargetSupported(this->_renderer) == SDL_TRUE;
+}
+
+void Graphics::beginRenderToTexture(SDL_Texture* p_texture){
+    SDL_SetRenderTarget(this->_renderer, p_texture);
+
+    Uint8 r, g, b, a;
+    SDL_GetRenderDrawColor(this->_renderer, &r, &g, &b, &a);
+    SDL_SetRenderDrawColor(this->_renderer, 0, 0, 0, 0);
+    SDL_RenderClear(this->_renderer);
+    SDL_SetRenderDrawColor(this->_renderer, r, g, b, a);
+}
+
+void Graphics::endRenderToTexture(){
+    SDL_SetRenderTarget(this->_renderer, NULL);
+}
+
 void Graphics::blitSurface(SDL_Texture* p_texture, SDL_Rect* p_src, SDL_Rect* p_dst){
+    this->countDrawCall(p_texture);
     SDL_RenderCopy(this->_renderer, p_texture, p_src, p_dst);
 }
 
+void Graphics::renderGeometry(SDL_Texture* p_texture, const SDL_Vertex* p_vertices, int p_vertexCount,
+        const int* p_indices, int p_indexCount){
+    this->countDrawCall(p_texture);
+    SDL_RenderGeometry(this->_renderer, p_texture, p_vertices, p_vertexCount, p_indices, p_indexCount);
+}
+
+void Graphics::fillRects(const SDL_Rect* p_rects, int p_count, const SDL_Color &p_color){
+    this->countDrawCall(NULL);
+
+    Uint8 r, g, b, a;
+    SDL_GetRenderDrawColor(this->_renderer, &r, &g, &b, &a);
+    SDL_SetRenderDrawBlendMode(this->_renderer, p_color.a < 255 ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(this->_renderer, p_color.r, p_color.g, p_color.b, p_color.a);
+    SDL_RenderFillRects(this->_renderer, p_rects, p_count);
+    SDL_SetRenderDrawColor(this->_renderer, r, g, b, a);
+    SDL_SetRenderDrawBlendMode(this->_renderer, SDL_BLENDMODE_NONE);
+}
+
 void Graphics::flip(){
+    PROFILE_ZONE("Graphics::flip");
     SDL_RenderPresent(this->_renderer);
+
+    this->_frameDrawCalls = this->_drawCalls;
+    this->_frameTextureBinds = this->_textureBinds;
+    this->_drawCalls = 0;
+    this->_textureBinds = 0;
+    this->_boundTexture = NULL;
 }
 
 void Graphics::clear(){
@@ -35,4 +137,26 @@ void Graphics::clear(){
 
 SDL_Renderer* Graphics::getRenderer() const{
     return this->_renderer; 
+}
+
+bool Graphics::isVsyncEnabled() const{
+    SDL_RendererInfo info;
+    return SDL_GetRendererInfo(this->_renderer, &info) == 0 && (info.flags & SDL_RENDERER_PRESENTVSYNC) != 0;
+}
+
+std::shared_ptr<SDL_Texture> Graphics::makeSharedTexture(SDL_Texture* p_texture){
+    std::shared_ptr<bool> rendererAlive = this->_rendererAlive;
+    return std::shared_ptr<SDL_Texture>(p_texture, [rendererAlive](SDL_Texture* p_texture){
+        if(p_texture != NULL && *rendererAlive){
+            SDL_DestroyTexture(p_texture);
+        }
+    });
+}
+
+void Graphics::countDrawCall(SDL_Texture* p_texture){
+    this->_drawCalls++;
+    if(p_texture != NULL && p_texture != this->_boundTexture){
+        this->_textureBinds++;
+        this->_boundTexture = p_texture;
+    }
 }
\ No newline at end of file
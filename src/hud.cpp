@@ -1,10 +1,49 @@
 #include "hud.h"
 #include "graphics.h"
+#include "profiler.h"
+#include "globals.h"
+#include <algorithm>
 #include <iostream>
 
-Hud::Hud(){}
+namespace{
+    const int PERF_DIGIT_WIDTH = 8 * globals::SPRITE_SCALE;
+    const int PERF_ROW_HEIGHT = PERF_DIGIT_WIDTH + 2;
+    const int PERF_ROWS = 8;
+    const int PERF_PANEL_WIDTH = 168;
+    const int PERF_X = globals::SCREEN_WIDTH - PERF_PANEL_WIDTH - 4; // left of the panel
+    const int PERF_Y = 4; // top of the panel
+    const int PERF_GRAPH_HEIGHT = 60;
+    const float PERF_GRAPH_MAX_TIME = 100.0f / 3.0f; // frame time reaching the top of the graph, in ms
+    const float PERF_TARGET_FRAME_TIME = 1000.0f / 60.0f; // frame time marked on the graph, in ms
 
-Hud::Hud(Graphics &p_graphics, Player &p_player){
+    const SDL_Color PERF_PANEL_COLOR = {0, 0, 0, 170};
+    const SDL_Color PERF_TEXT_COLOR = {255, 255, 255, 255};
+    const SDL_Color PERF_TARGET_COLOR = {160, 160, 160, 255};
+    const SDL_Color PERF_ROW_COLORS[PERF_ROWS] = {
+        {255, 255, 255, 255}, // FPS
+        {80, 220, 80, 255}, // frame time
+        {80, 140, 255, 255}, // update time
+        {255, 160, 40, 255}, // render time
+        {190, 90, 255, 255}, // draw calls
+        {60, 220, 220, 255}, // texture binds
+        {240, 60, 60, 255}, // collision tests
+        {250, 230, 60, 255} // entities
+    };
+}
+
+Hud::Hud():
+    _perfOverlayVisible(false),
+    _perfStats(),
+    _frameTimes(),
+    _frameTimeIndex(0)
+{}
+
+Hud::Hud(Graphics &p_graphics, Player &p_player):
+    _perfOverlayVisible(false),
+    _perfStats(),
+    _frameTimes(),
+    _frameTimeIndex(0)
+{
     this->_player = p_player;
     this->_healthBarSprite = Sprite(p_graphics, "../res/gfx/TextBox.png", 0, 40, 64, 8, 35, 70);
     this->_healthNumber1 = Sprite(p_graphics, "../res/gfx/TextBox.png", 0, 56, 8, 8, 66, 70);
@@ -14,9 +53,10 @@ Hud::Hud(Graphics &p_graphics, Player &p_player){
     this->_expBar = Sprite(p_graphics, "../res/gfx/TextBox.png", 0, 72, 40, 8, 83, 52);
     this->_slash = Sprite(p_graphics, "../res/gfx/TextBox.png", 72, 48, 8, 8, 100, 36);
     this->_dashes = Sprite(p_graphics, "../res/gfx/TextBox.png", 81, 51, 15, 11, 132, 26);
+    this->_perfDigit = Sprite(p_graphics, "../res/gfx/TextBox.png", 0, 56, 8, 8, 0, 0);
 }
 
-void Hud::update(int p_elapsedTime, Player &p_player){
+void Hud::update(float p_elapsedTime, Player &p_player){
     this->_player = p_player;
     this->_healthNumber1.setSourceRectX(8 * this->_player.getCurrentHealth());
 
@@ -26,6 +66,7 @@ void Hud::update(int p_elapsedTime, Player &p_player){
 }
 
 void Hud::draw(Graphics &p_graphics){
+    PROFILE_ZONE("Hud::draw");
     this->_healthBarSprite.draw(p_graphics, this->_healthBarSprite.getX(), this->_healthBarSprite.getY());
     this->_healthNumber1.draw(p_graphics, this->_healthNumber1.getX(), this->_healthNumber1.getY());
     this->_currentHealthBar.draw(p_graphics, this->_currentHealthBar.getX(), this->_currentHealthBar.getY());
@@ -35,4 +76,86 @@ void Hud::draw(Graphics &p_graphics){
     this->_slash.draw(p_graphics, this->_slash.getX(), this->_slash.getY());
     this->_dashes.draw(p_graphics, this->_dashes.getX(), this->_dashes.getY());
     //use a for loop each, will hbave to make a vector that stores all sprites* and foreach loop thru them
+
+    if(this->_perfOverlayVisible){
+        this->drawPerfOverlay(p_graphics);
+    }
+}
+
+void Hud::setPerfStats(const PerfStats &p_stats){
+    this->_perfStats = p_stats;
+    this->_frameTimes[this->_frameTimeIndex] = p_stats.FrameTime;
+    this->_frameTimeIndex = (this->_frameTimeIndex + 1) % PERF_GRAPH_FRAMES;
+}
+
+void Hud::drawPerfOverlay(Graphics &p_graphics){
+    int graphTop = PERF_Y + 4 + PERF_ROWS * PERF_ROW_HEIGHT + 4;
+    SDL_Rect panel = {PERF_X, PERF_Y, PERF_PANEL_WIDTH, graphTop + PERF_GRAPH_HEIGHT + 4 - PERF_Y};
+    p_graphics.fillRects(&panel, 1, PERF_PANEL_COLOR);
+
+    //FPS over the whole graph, a single frame's is too noisy to read
+    float totalTime = 0.0f;
+    int frames = 0;
+    for(int i = 0; i < PERF_GRAPH_FRAMES; i++){
+        if(this->_frameTimes[i] > 0.0f){
+            totalTime += this->_frameTimes[i];
+            frames++;
+        }
+    }
+    float fps = totalTime > 0.0f ? frames * 1000.0f / totalTime : 0.0f;
+
+    const float values[PERF_ROWS] = {fps, this->_perfStats.FrameTime, this->_perfStats.UpdateTime,
+        this->_perfStats.RenderTime, (float)this->_perfStats.DrawCalls, (float)this->_perfStats.TextureBinds,
+        (float)this->_perfStats.CollisionTests, (float)this->_perfStats.Entities};
+    const int decimals[PERF_ROWS] = {0, 2, 2, 2, 0, 0, 0, 0};
+    for(int row = 0; row < PERF_ROWS; row++){
+        int y = PERF_Y + 4 + row * PERF_ROW_HEIGHT;
+        SDL_Rect swatch = {PERF_X + 4, y, 6, PERF_DIGIT_WIDTH};
+        p_graphics.fillRects(&swatch, 1, PERF_ROW_COLORS[row]);
+        this->drawNumber(p_graphics, values[row], decimals[row], PERF_X + 14, y);
+    }
+
+    //oldest frame on the left, one pixel per frame
+    int graphBottom = graphTop + PERF_GRAPH_HEIGHT;
+    for(int i = 0; i < PERF_GRAPH_FRAMES; i++){
+        float frameTime = this->_frameTimes[(this->_frameTimeIndex + i) % PERF_GRAPH_FRAMES];
+        int height = std::min(PERF_GRAPH_HEIGHT, (int)(frameTime * PERF_GRAPH_HEIGHT / PERF_GRAPH_MAX_TIME + 0.5f));
+        this->_graphBars[i].x = PERF_X + 14 + i;
+        this->_graphBars[i].y = graphBottom - height;
+        this->_graphBars[i].w = 1;
+        this->_graphBars[i].h = height;
+    }
+    p_graphics.fillRects(this->_graphBars, PERF_GRAPH_FRAMES, PERF_ROW_COLORS[1]);
+
+    int targetHeight = (int)(PERF_TARGET_FRAME_TIME * PERF_GRAPH_HEIGHT / PERF_GRAPH_MAX_TIME + 0.5f);
+    SDL_Rect target = {PERF_X + 14, graphBottom - targetHeight, PERF_GRAPH_FRAMES, 1};
+    p_graphics.fillRects(&target, 1, PERF_TARGET_COLOR);
+}
+
+void Hud::drawNumber(Graphics &p_graphics, float p_value, int p_decimals, int p_x, int p_y){
+    //fixed point, so the digits come from integer math into a buffer on the stack
+    long long scale = 1;
+    for(int i = 0; i < p_decimals; i++){
+        scale *= 10;
+    }
+    long long value = p_value > 0.0f ? (long long)(p_value * scale + 0.5f) : 0;
+
+    int digits[20];
+    int count = 0;
+    do{
+        digits[count++] = value % 10;
+        value /= 10;
+    } while((value > 0 || count <= p_decimals) && count < 20);
+
+    int x = p_x;
+    for(int i = count - 1; i >= 0; i--){
+        this->_perfDigit.setSourceRectX(8 * digits[i]);
+        this->_perfDigit.draw(p_graphics, x, p_y);
+        x += PERF_DIGIT_WIDTH;
+        if(i == p_decimals && p_decimals > 0){
+            SDL_Rect point = {x, p_y + PERF_DIGIT_WIDTH - 4, 3, 3};
+            p_graphics.fillRects(&point, 1, PERF_TEXT_COLOR);
+            x += 5;
+        }
+    }
 }
\ No newline at end of file
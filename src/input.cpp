@@ -4,29 +4,52 @@
 Handles all inputs and checks different states of a key
 */
 
+namespace{
+    inline bool isValidScancode(int p_key){
+        return p_key >= 0 && p_key < SDL_NUM_SCANCODES;
+    }
+}
+
 void Input::beginNewFrame(){
-    this->_pressedKeys.clear();
-    this->_releasedKeys.clear();
+    this->_pressedKeys.reset();
+    this->_releasedKeys.reset();
 }
 
 void Input::keyDownEvent(const SDL_Event& e){
-    this->_pressedKeys[e.key.keysym.scancode] = true;
-    this->_heldKeys[e.key.keysym.scancode] = true;
+    if(isValidScancode(e.key.keysym.scancode)){
+        this->_pressedKeys.set(e.key.keysym.scancode);
+        this->_heldKeys.set(e.key.keysym.scancode);
+    }
 }
 
 void Input::keyUpEvent(const SDL_Event& e){
-    this->_releasedKeys[e.key.keysym.scancode] = true;
-    this->_heldKeys[e.key.keysym.scancode] = false;
+    if(isValidScancode(e.key.keysym.scancode)){
+        this->_releasedKeys.set(e.key.keysym.scancode);
+        this->_heldKeys.reset(e.key.keysym.scancode);
+    }
+}
+
+bool Input::wasKeyPressed(SDL_Scancode p_key) const{
+    return isValidScancode(p_key) && this->_pressedKeys.test(p_key);
 }
 
-bool Input::wasKeyPressed(SDL_Scancode p_key){
-    return this->_pressedKeys[p_key];
+bool Input::wasKeyReleased(SDL_Scancode p_key) const{
+    return isValidScancode(p_key) && this->_releasedKeys.test(p_key);
 }
 
-bool Input::wasKeyReleased(SDL_Scancode p_key){
-    return this->_releasedKeys[p_key];
+bool Input::isKeyHeld(SDL_Scancode p_key) const{
+    return isValidScancode(p_key) && this->_heldKeys.test(p_key);
+}
+
+
+bool Input::hasKeyEvents() const{
+    return this->_pressedKeys.any() || this->_releasedKeys.any();
 }
 
-bool Input::isKeyHeld(SDL_Scancode p_key){
-    return this->_heldKeys[p_key];
+void Input::setKeyState(SDL_Scancode p_key, bool p_pressed, bool p_released, bool p_held){
+    if(isValidScancode(p_key)){
+        this->_pressedKeys.set(p_key, p_pressed);
+        this->_releasedKeys.set(p_key, p_released);
+        this->_heldKeys.set(p_key, p_held);
+    }
 }
\ No newline at end of file
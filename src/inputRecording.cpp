@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+#include "inputRecording.h"
+
+namespace{
+    const char RECORDING_MAGIC[4] = {'C', 'S', 'I', 'R'};
+    const uint32_t RECORDING_VERSION = 1;
+
+    const int SCANCODE_BITS = 9; // SDL_NUM_SCANCODES is 512
+    const uint16_t SCANCODE_MASK = (1 << SCANCODE_BITS) - 1;
+    const uint16_t KEY_PRESSED = 1 << SCANCODE_BITS;
+    const uint16_t KEY_RELEASED = 1 << (SCANCODE_BITS + 1);
+    const uint16_t KEY_HELD = 1 << (SCANCODE_BITS + 2);
+
+    void writeU32(std::vector<char> &p_bytes, uint32_t p_value){
+        for(int i = 0; i < 4; i++){
+            p_bytes.push_back((char)((p_value >> (i * 8)) & 0xFF));
+        }
+    }
+
+    void writeVarint(std::vector<char> &p_bytes, uint32_t p_value){
+        while(p_value >= 0x80){
+            p_bytes.push_back((char)((p_value & 0x7F) | 0x80));
+            p_value >>= 7;
+        }
+        p_bytes.push_back((char)p_value);
+    }
+
+    /**
+     * @class RecordingReader
+     * @brief Bounds checked little endian reader over a recording, failing once on any read past the end.
+     */
+    class RecordingReader {
+    public:
+        RecordingReader(const std::vector<char> &p_bytes):
+            _bytes(p_bytes),
+            _pos(0),
+            _ok(true)
+        {}
+
+        uint8_t readU8(){
+            if(this->_pos >= this->_bytes.size()){
+                this->_ok = false;
+                return 0;
+            }
+            return (uint8_t)this->_bytes[this->_pos++];
+        }
+
+        uint16_t readU16(){
+            uint16_t low = this->readU8();
+            return low | (uint16_t)(this->readU8() << 8);
+        }
+
+        uint32_t readU32(){
+            uint32_t value = 0;
+            for(int i = 0; i < 4; i++){
+                value |= (uint32_t)this->readU8() << (i * 8);
+            }
+            return value;
+        }
+
+        uint32_t readVarint(){
+            uint32_t value = 0;
+            for(int shift = 0; shift < 35; shift += 7){
+                uint8_t byte = this->readU8();
+                value |= (uint32_t)(byte & 0x7F) << shift;
+                if((byte & 0x80) == 0){
+                    return value;
+                }
+            }
+            this->_ok = false;
+            return 0;
+        }
+
+        size_t getRemaining() const { return this->_bytes.size() - this->_pos; }
+        bool isOk() const { return this->_ok; }
+
+    private:
+        const std::vector<char> &_bytes;
+        size_t _pos;
+        bool _ok;
+    };
+}
+
+InputRecording::InputRecording():
+    _tickCount(0),
+    _tickRate(0),
+    _replayedTicks(0),
+    _nextChange(0)
+{}
+
+void InputRecording::record(const Input &p_input){
+    //most ticks change nothing, only then are the scancodes walked
+    if(p_input.hasKeyEvents()){
+        for(int key = 0; key < SDL_NUM_SCANCODES; key++){
+            SDL_Scancode scancode = (SDL_Scancode)key;
+            bool pressed = p_input.wasKeyPressed(scancode);
+            bool released = p_input.wasKeyReleased(scancode);
+            if(pressed || released){
+                KeyChange change;
+                change.Tick = this->_tickCount;
+                change.Key = (uint16_t)key | (pressed ? KEY_PRESSED : 0) | (released ? KEY_RELEASED : 0) |
+                    (p_input.isKeyHeld(scancode) ? KEY_HELD : 0);
+                this->_changes.push_back(change);
+            }
+        }
+    }
+    this->_tickCount++;
+}
+
+bool InputRecording::replay(Input &p_input){
+    if(this->isFinished()){
+        return false;
+    }
+
+    //edges only last one tick, held keys stay held until a change releases them
+    for(int i = 0; i < this->_replayedKeys.size(); i++){
+        SDL_Scancode scancode = (SDL_Scancode)this->_replayedKeys[i];
+        p_input.setKeyState(scancode, false, false, p_input.isKeyHeld(scancode));
+    }
+    this->_replayedKeys.clear();
+
+    while(this->_nextChange < this->_changes.size() && this->_changes[this->_nextChange].Tick == this->_replayedTicks){
+        uint16_t key = this->_changes[this->_nextChange].Key;
+        p_input.setKeyState((SDL_Scancode)(key & SCANCODE_MASK), (key & KEY_PRESSED) != 0,
+            (key & KEY_RELEASED) != 0, (key & KEY_HELD) != 0);
+        this->_replayedKeys.push_back(key & SCANCODE_MASK);
+        this->_nextChange++;
+    }
+    this->_replayedTicks++;
+    return true;
+}
+
+bool InputRecording::save(const std::string &p_filePath) const{
+    std::vector<char> bytes(RECORDING_MAGIC, RECORDING_MAGIC + sizeof(RECORDING_MAGIC));
+    writeU32(bytes, RECORDING_VERSION);
+    writeU32(bytes, this->_tickRate);
+    writeU32(bytes, this->_tickCount);
+    writeU32(bytes, this->_changes.size());
+
+    uint32_t previousTick = 0;
+    for(int i = 0; i < this->_changes.size(); i++){
+        writeVarint(bytes, this->_changes[i].Tick - previousTick);
+        bytes.push_back((char)(this->_changes[i].Key & 0xFF));
+        bytes.push_back((char)(this->_changes[i].Key >> 8));
+        previousTick = this->_changes[i].Tick;
+    }
+
+    std::ofstream out(p_filePath.c_str(), std::ios::binary | std::ios::trunc);
+    if(!out){
+        printf("\nError: Unable to write the input recording %s\n", p_filePath.c_str());
+        return false;
+    }
+    out.write(bytes.data(), bytes.size());
+    return out.good();
+}
+
+bool InputRecording::load(const std::string &p_filePath){
+    std::ifstream in(p_filePath.c_str(), std::ios::binary);
+    if(!in){
+        printf("\nError: Unable to open the input recording %s\n", p_filePath.c_str());
+        return false;
+    }
+    std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if(bytes.size() < sizeof(RECORDING_MAGIC) ||
+            !std::equal(RECORDING_MAGIC, RECORDING_MAGIC + sizeof(RECORDING_MAGIC), bytes.begin())){
+        printf("\nError: %s is not an input recording\n", p_filePath.c_str());
+        return false;
+    }
+
+    RecordingReader reader(bytes);
+    for(int i = 0; i < sizeof(RECORDING_MAGIC); i++){
+        reader.readU8();
+    }
+    if(reader.readU32() != RECORDING_VERSION){
+        printf("\nError: Unsupported input recording version in %s\n", p_filePath.c_str());
+        return false;
+    }
+
+    int tickRate = reader.readU32();
+    uint32_t tickCount = reader.readU32();
+    uint32_t changeCount = reader.readU32();
+
+    //a change takes at least 3 bytes, which keeps a corrupt count from allocating gigabytes
+    std::vector<KeyChange> changes;
+    if(changeCount > reader.getRemaining() / 3){
+        printf("\nError: Corrupt input recording %s\n", p_filePath.c_str());
+        return false;
+    }
+    changes.reserve(changeCount);
+
+    uint32_t tick = 0;
+    for(uint32_t i = 0; i < changeCount; i++){
+        KeyChange change;
+        tick += reader.readVarint();
+        change.Tick = tick;
+        change.Key = reader.readU16();
+        changes.push_back(change);
+    }
+    if(!reader.isOk() || (changeCount > 0 && tick >= tickCount)){
+        printf("\nError: Corrupt input recording %s\n", p_filePath.c_str());
+        return false;
+    }
+
+    this->_changes.swap(changes);
+    this->_tickCount = tickCount;
+    this->_tickRate = tickRate;
+    this->_replayedTicks = 0;
+    this->_nextChange = 0;
+    this->_replayedKeys.clear();
+    return true;
+}
@@ -1,419 +1,581 @@
 #include <SDL2/SDL.h>
-#include <sstream>
 #include <algorithm>
 #include <cmath>
 #include <iostream>
 
 #include "level.h"
 #include "graphics.h"
-#include "tinyxml2.h"
-#include "utils.h"
+#include "mapData.h"
+#include "levelCache.h"
+#include "chunkStreamer.h"
 #include "animatedTile.h"
 #include "player.h"
 #include "enemy.h"
+#include "profiler.h"
 
-using namespace tinyxml2;
+namespace{
+    const int TILE_CHUNK_SIZE = 512;
+    const int CULL_MARGIN_TILES = 1;
+    const int SOLID_RUN_REACH = 8;
 
-Level::Level(){}
+    Vector2f getSourcePosition(const AnimatedTile &p_tile){
+        return p_tile.getCurrentTilesetPosition();
+    }
+}
 
-Level::Level(std::string p_mapName, Graphics &p_graphics):
-    _mapName(p_mapName),
-    _size(Vector2f(0,0))
+Level::Level():
+    _tileDrawMode(tiledraw::BATCHED),
+    _collisionTests(0)
+{}
+
+Level::Level(const std::shared_ptr<const LevelTemplate> &p_template, Graphics &p_graphics, int p_streamingRadius):
+    _mapName(p_template->Name),
+    _size(Vector2f(0,0)),
+    _template(p_template),
+    _tilesets(p_template->Tilesets),
+    _tileDrawMode(tiledraw::BATCHED),
+    _collisionTests(0)
 {
-    this->loadMap(p_mapName, p_graphics);
+    bool streamed = p_template->Map->Infinite && p_streamingRadius > 0;
+    this->buildFromTemplate(*p_template, p_graphics, !streamed);
+    if(streamed){
+        this->_streamer.reset(new ChunkStreamer(p_template, p_streamingRadius));
+    }
 }
 
 Level::~Level(){}
 
-void Level::update(int p_elapsedTime, Player &p_player, Graphics &p_graphics){
+Level::Level(Level &&p_other) = default;
+
+Level &Level::operator=(Level &&p_other) = default;
+
+void Level::update(float p_elapsedTime, Player &p_player){
+    PROFILE_ZONE("Level::update");
+    if(this->_streamer){
+        this->_streamer->update(p_player.getBoundingBox(), p_elapsedTime);
+    }
+
     for(int i = 0; i < this->_animatedTileList.size(); i++){
         this->_animatedTileList[i].update(p_elapsedTime);
     }
 
     for(int i = 0; i < this->_enemies.size(); i++){
+        this->_enemies[i]->savePreviousPosition();
         this->_enemies[i]->update(p_elapsedTime, p_player);
+        this->_enemyGrid.move(i, this->_enemies[i]->getBoundingBox());
     }
-
-    p_player.resetLevelOnDeath(*this, p_graphics);
 }
 
-void Level::draw(Graphics &p_graphics){
-    for(int i = 0; i < this->_tileList.size(); i++){
-        this->_tileList[i].draw(p_graphics);
+void Level::draw(Graphics &p_graphics, const Camera &p_camera, float p_alpha){
+    PROFILE_ZONE("Level::draw");
+    tiledraw::Mode mode = this->_tileDrawMode;
+    if(mode == tiledraw::CACHED && !p_graphics.supportsRenderTargets()){
+        mode = tiledraw::BATCHED;
     }
 
-    for(int i = 0; i < this->_animatedTileList.size(); i++){
-        this->_animatedTileList[i].draw(p_graphics);
+    //the cache replaces the static layers, animated tiles are always drawn live on top
+    if(this->_streamer){
+        this->_streamer->draw(p_graphics, p_camera);
+    } else if(mode == tiledraw::CACHED){
+        this->_tileChunkCache.draw(p_graphics, p_camera, this->_tileGrid, *this->_template);
+    } else {
+        this->drawTileGrid(p_graphics, p_camera, mode == tiledraw::BATCHED);
     }
+    this->drawTileLayers(p_graphics, p_camera, this->_animatedTileList, this->_animatedTileLayers,
+        mode != tiledraw::PER_TILE);
 
     for(int i = 0; i < this->_enemies.size(); i++){
-        this->_enemies[i]->draw(p_graphics);
+        if(p_camera.isVisible(this->_enemies[i]->getBoundingBox())){
+            this->_enemies[i]->draw(p_graphics, p_camera, p_alpha);
+        }
     }
 }
 
-std::vector<Rectangle> Level::checkTileCollisions(const Rectangle &p_other){
-    std::vector<Rectangle> others;
-    for(int i = 0; i < this->_collisionRects.size(); i++){
-        if(this->_collisionRects[i].collidesWith(p_other)){
-            others.push_back(this->_collisionRects[i]);
+void Level::drawTileGrid(Graphics &p_graphics, const Camera &p_camera, bool p_batched){
+    int tileWidth = this->_tileSize.x * globals::SPRITE_SCALE;
+    int tileHeight = this->_tileSize.y * globals::SPRITE_SCALE;
+    if(tileWidth <= 0 || tileHeight <= 0 || !this->_template){
+        return;
+    }
+
+    //the visible cells are a plain range of rows and columns, grown by a margin like the animated layers
+    Rectangle view = p_camera.getView();
+    int firstColumn = std::max(0, view.getLeft() / tileWidth - CULL_MARGIN_TILES);
+    int lastColumn = std::min(this->_tileGrid.getWidth() - 1, view.getRight() / tileWidth + CULL_MARGIN_TILES);
+    int firstRow = std::max(0, view.getTop() / tileHeight - CULL_MARGIN_TILES);
+    int lastRow = std::min(this->_tileGrid.getHeight() - 1, view.getBottom() / tileHeight + CULL_MARGIN_TILES);
+
+    for(int l = 0; l < this->_tileGrid.getLayerCount(); l++){
+        if(this->_template->Map->Layers[l].Collision){
+            continue;
+        }
+        for(int row = firstRow; row <= lastRow; row++){
+            const uint32_t* gids = this->_tileGrid.getRow(l, row);
+            for(int column = firstColumn; column <= lastColumn; column++){
+                if(gids[column] == 0){
+                    continue;
+                }
+                TileGid gid = this->_template->getGid(gids[column]);
+                if(gid.Tileset == -1 || gid.Animation != -1){
+                    continue;
+                }
+                int x = p_camera.toScreenX(column * tileWidth);
+                int y = p_camera.toScreenY(row * tileHeight);
+                if(p_batched){
+                    this->_tileBatches[gid.Tileset].addTile(gid.SourcePosition, this->_tileSize, Vector2f(x, y));
+                } else {
+                    SDL_Rect src = {gid.SourcePosition.x, gid.SourcePosition.y, this->_tileSize.x, this->_tileSize.y};
+                    SDL_Rect dst = {x, y, tileWidth, tileHeight};
+                    p_graphics.blitSurface(this->_tilesets[gid.Tileset].Texture.get(), &src, &dst);
+                }
+            }
+        }
+
+        if(p_batched){
+            for(int b = 0; b < this->_tilesets.size(); b++){
+                this->_tileBatches[b].draw(p_graphics);
+                this->_tileBatches[b].clear();
+            }
+        }
+    }
+}
+
+template <class T>
+void Level::drawTileLayers(Graphics &p_graphics, const Camera &p_camera, const std::vector<T> &p_tiles,
+        std::vector<TileLayerRange> &p_layers, bool p_batched){
+    int tileWidth = this->_tileSize.x * globals::SPRITE_SCALE;
+    int tileHeight = this->_tileSize.y * globals::SPRITE_SCALE;
+    if(tileWidth <= 0 || tileHeight <= 0){
+        return;
+    }
+
+    //visible rows and columns, grown by a margin so tiles sliding in at the edges are never missed
+    Rectangle view = p_camera.getView();
+    int firstColumn = view.getLeft() / tileWidth - CULL_MARGIN_TILES;
+    int lastColumn = view.getRight() / tileWidth + CULL_MARGIN_TILES;
+    int firstRow = std::max(0, view.getTop() / tileHeight - CULL_MARGIN_TILES);
+    int lastRow = std::min(this->_size.y - 1, view.getBottom() / tileHeight + CULL_MARGIN_TILES);
+
+    for(int l = 0; l < p_layers.size(); l++){
+        TileLayerRange &layer = p_layers[l];
+        for(int b = 0; b < layer.BatchCount; b++){
+            this->_tileBatches[layer.FirstBatch + b].clear();
+        }
+
+        for(int row = firstRow; row <= lastRow && row + 1 < layer.RowStarts.size(); row++){
+            typename std::vector<T>::const_iterator end = p_tiles.begin() + layer.RowStarts[row + 1];
+            typename std::vector<T>::const_iterator tile = std::lower_bound(p_tiles.begin() + layer.RowStarts[row], end,
+                firstColumn * tileWidth, [](const T &p_tile, int p_x){ return p_tile.getPosition().x < p_x; });
+
+            for(; tile != end && tile->getPosition().x <= lastColumn * tileWidth; ++tile){
+                if(!p_batched){
+                    tile->draw(p_graphics, p_camera);
+                    continue;
+                }
+                for(int b = layer.FirstBatch; b < layer.FirstBatch + layer.BatchCount; b++){
+                    if(this->_tileBatches[b].getTexture() == tile->getTileset()){
+                        this->_tileBatches[b].addTile(getSourcePosition(*tile), tile->getSize(),
+                            Vector2f(p_camera.toScreenX(tile->getPosition().x), p_camera.toScreenY(tile->getPosition().y)));
+                        break;
+                    }
+                }
+            }
+        }
+
+        if(p_batched){
+            for(int b = 0; b < layer.BatchCount; b++){
+                this->_tileBatches[layer.FirstBatch + b].draw(p_graphics);
+            }
         }
     }
-    return others;
 }
 
-std::vector<Object> Level::checkObjectCollisions(const Rectangle &p_other){
-    std::vector<Object> others;
+void Level::checkTileCollisions(const Rectangle &p_other, std::vector<Rectangle> &p_others){
+    p_others.clear();
+    this->_queryIds.clear();
+    this->_collisionGrid.query(p_other, this->_queryIds);
+    this->_collisionTests += this->_queryIds.size();
+    for(int i = 0; i < this->_queryIds.size(); i++){
+        const Rectangle &rect = this->_collisionRects[this->_queryIds[i]];
+        if(rect.collidesWith(p_other)){
+            p_others.push_back(rect);
+        }
+    }
+    this->addSolidCells(p_other, p_others);
+}
+
+void Level::addSolidCells(const Rectangle &p_other, std::vector<Rectangle> &p_others) const {
+    int tileWidth = this->_tileSize.x * globals::SPRITE_SCALE;
+    int tileHeight = this->_tileSize.y * globals::SPRITE_SCALE;
+    if(this->_collisionMask.getWidth() == 0 || tileWidth <= 0 || tileHeight <= 0){
+        return;
+    }
+
+    //cells touched by the rectangle, edges included like Rectangle::collidesWith
+    int firstColumn = std::max(0, p_other.getLeft() / tileWidth);
+    int lastColumn = std::min(this->_collisionMask.getWidth() - 1, p_other.getRight() / tileWidth);
+    int firstRow = std::max(0, p_other.getTop() / tileHeight);
+    int lastRow = std::min(this->_collisionMask.getHeight() - 1, p_other.getBottom() / tileHeight);
+
+    int first = p_others.size();
+    for(int row = firstRow; row <= lastRow; row++){
+        for(int column = firstColumn; column <= lastColumn; column++){
+            if(!this->_collisionMask.isSolid(column, row)){
+                continue;
+            }
+            int start = column;
+            while(start > firstColumn - SOLID_RUN_REACH && this->_collisionMask.isSolid(start - 1, row)){
+                start--;
+            }
+            int end = column;
+            while(end < lastColumn + SOLID_RUN_REACH && this->_collisionMask.isSolid(end + 1, row)){
+                end++;
+            }
+            column = end;
+
+            //stack the run on the one right above it when they span the same columns
+            Rectangle run = Rectangle(start * tileWidth, row * tileHeight, (end - start + 1) * tileWidth, tileHeight);
+            bool stacked = false;
+            for(int i = first; i < p_others.size() && !stacked; i++){
+                const Rectangle &above = p_others[i];
+                if(above.getLeft() == run.getLeft() && above.getWidth() == run.getWidth() && above.getBottom() == run.getTop()){
+                    p_others[i] = Rectangle(above.getLeft(), above.getTop(), above.getWidth(), above.getHeight() + tileHeight);
+                    stacked = true;
+                }
+            }
+            if(!stacked){
+                p_others.push_back(run);
+            }
+        }
+    }
+}
+
+void Level::checkObjectCollisions(const Rectangle &p_other, std::vector<Object> &p_others){
+    p_others.clear();
+    this->_collisionTests += this->_objects.size();
     for(int i = 0; i < this->_objects.size(); i++){
         if(this->_objects[i].collidesWith(p_other)){
-            this->_objects[i]._isActive = true;
-            others.push_back(this->_objects[i]);
+            this->_objects[i].setActive(true);
+            p_others.push_back(this->_objects[i]);
         }
     }
-    return others;
 }
 
 
-std::vector<Slope> Level::checkSlopeCollisions(const Rectangle &p_other){
-    std::vector<Slope> others;
-    for(int i = 0; i < this->_slopes.size(); i++){
-        if(this->_slopes[i].collidesWith(p_other)){
-            others.push_back(this->_slopes[i]);
+void Level::checkSlopeCollisions(const Rectangle &p_other, std::vector<Slope> &p_others){
+    p_others.clear();
+    this->_queryIds.clear();
+    this->_slopeGrid.query(p_other, this->_queryIds);
+    this->_collisionTests += this->_queryIds.size();
+    for(int i = 0; i < this->_queryIds.size(); i++){
+        const Slope &slope = this->_slopes[this->_queryIds[i]];
+        if(slope.collidesWith(p_other)){
+            p_others.push_back(slope);
         }
     }
-    return others;
 }
 
-std::vector<Door> Level::checkDoorCollisions(const Rectangle &p_other){
-    std::vector<Door> others;
-    for(int i = 0; i < this->_doorList.size(); i++){
-        if(this->_doorList[i].collidesWith(p_other)){
-            others.push_back(this->_doorList[i]);
+void Level::checkDoorCollisions(const Rectangle &p_other, std::vector<Door> &p_others){
+    p_others.clear();
+    this->_queryIds.clear();
+    this->_doorGrid.query(p_other, this->_queryIds);
+    this->_collisionTests += this->_queryIds.size();
+    for(int i = 0; i < this->_queryIds.size(); i++){
+        const Door &door = this->_doorList[this->_queryIds[i]];
+        if(door.collidesWith(p_other)){
+            p_others.push_back(door);
         }
     }
-    return others;
 }
 
-std::vector<Enemy*> Level::checkEnemyCollisions(const Rectangle &p_other){
-    std::vector<Enemy*> others;
-    for(int i = 0; i < this->_enemies.size(); i++){
-        if(this->_enemies[i]->getBoundingBox().collidesWith(p_other)){
-            others.push_back(this->_enemies[i]);
+void Level::checkEnemyCollisions(const Rectangle &p_other, std::vector<Enemy*> &p_others){
+    p_others.clear();
+    this->_queryIds.clear();
+    this->_enemyGrid.query(p_other, this->_queryIds);
+    this->_collisionTests += this->_queryIds.size();
+    for(int i = 0; i < this->_queryIds.size(); i++){
+        Enemy* enemy = this->_enemies[this->_queryIds[i]].get();
+        if(enemy->getBoundingBox().collidesWith(p_other)){
+            p_others.push_back(enemy);
         }
     }
-    return others;
 }
 
 const Vector2f Level::getPlayerSpawnPoint() const {
     return this->_spawnPoint;
 }
 
-Vector2f Level::getTilesetPosition(Tileset p_tls, int p_gid, int p_tileWidth, int p_tileHeight){
-    int tilesetWidth, tilesetHeight;
-    SDL_QueryTexture(p_tls.Texture, NULL, NULL, &tilesetWidth, &tilesetHeight);
-    int tsxx = (p_gid - 1) % (tilesetWidth / p_tileWidth);
-    tsxx *= p_tileWidth;
-    int tsyy = 0;
-    int amt = ((p_gid - p_tls.FirstGid) / (tilesetWidth / p_tileWidth));
-    tsyy = p_tileHeight * amt;
-    Vector2f finalTileSetPos = Vector2f(tsxx, tsyy);
-    
-    return finalTileSetPos;
+const Vector2f Level::getPixelSize() const {
+    return Vector2f(this->_size.x * this->_tileSize.x * globals::SPRITE_SCALE,
+        this->_size.y * this->_tileSize.y * globals::SPRITE_SCALE);
 }
 
-void Level::loadMap(std::string p_mapName, Graphics &p_graphics){
-    //Parse the XML file
-    XMLDocument doc;
-    std::stringstream ss;
-    ss << "../res/maps/" << p_mapName << ".tmx";
-    doc.LoadFile(ss.str().c_str());
-
-    XMLElement* mapNode = doc.FirstChildElement("map");
-
-    //Get the w,h of the whole map and store it in _size
-    int width, height;
-    mapNode->QueryIntAttribute("width", &width);
-    mapNode->QueryIntAttribute("height", &height);
-    this->_size = Vector2f(width, height);
-
-    //Get the w,h of the tiles and store it in _tileSize
-    int tileWidth, tileHeight;
-    mapNode->QueryIntAttribute("tilewidth", &tileWidth);
-    mapNode->QueryIntAttribute("tileheight", &tileHeight);
-    this->_tileSize = Vector2f(tileWidth, tileHeight);
-
-    //Loading the tilesets for the map
-    XMLElement* pTileset = mapNode->FirstChildElement("tileset");
-    if(pTileset != NULL){
-        while(pTileset){
-            int firstGid;
-            const char* source = pTileset->FirstChildElement("image")->Attribute("source");
-            char* path;
-            std::stringstream ss;
-            ss << source;
-            pTileset->QueryIntAttribute("firstgid", &firstGid);
-            SDL_Texture* tex = SDL_CreateTextureFromSurface(p_graphics.getRenderer(), p_graphics.loadImage(ss.str()));
-            this->_tilesets.push_back(Tileset(tex, firstGid));
-            
-            //get all the animations for that tileset before moving on
-            XMLElement * pTileA = pTileset->FirstChildElement("tile");
-            if(pTileA != NULL){
-                while(pTileA){
-                    AnimatedTileInfo ati;
-                    ati.StartTileId = pTileA->IntAttribute("id") + firstGid;
-                    ati.TilesetsFirstGid = firstGid;
-
-                    XMLElement* pAnimation = pTileA->FirstChildElement("animation");
-                    if(pAnimation != NULL){
-                        while(pAnimation){
-                            XMLElement* pFrame = pAnimation->FirstChildElement("frame");
-                            if(pFrame != NULL){
-                                while(pFrame){
-                                    ati.TileIds.push_back(pFrame->IntAttribute("tileid") + firstGid);
-                                    ati.Duration = pFrame->IntAttribute("duration");
-
-                                    pFrame = pFrame->NextSiblingElement("frame");
-                                }
-                            }
-                            this->_animatedTileInfo.push_back(ati);
-                            pAnimation = pAnimation->NextSiblingElement("tile");
-                        }
-                    }
-                    pTileA = pTileA->NextSiblingElement("tile");
+void Level::buildTileLayers(){
+    int tileHeight = std::max(1, this->_tileSize.y * globals::SPRITE_SCALE);
+    this->_tileBatches.clear();
+    for(int i = 0; i < this->_tilesets.size(); i++){
+        this->_tileBatches.push_back(TileBatch(this->_tilesets[i].Texture.get()));
+    }
+
+    //records where each row starts and gives the layer a batch per tileset it uses
+    auto indexLayers = [this, tileHeight](const auto &p_tiles, std::vector<TileLayerRange> &p_layers){
+        for(int l = 0; l < p_layers.size(); l++){
+            TileLayerRange &layer = p_layers[l];
+            layer.RowStarts.assign(this->_size.y + 1, layer.End);
+            int nextRow = 0;
+            for(int i = layer.Begin; i < layer.End; i++){
+                int row = std::min(std::max(p_tiles[i].getPosition().y / tileHeight, 0), this->_size.y);
+                while(nextRow <= row){
+                    layer.RowStarts[nextRow++] = i;
                 }
             }
-            pTileset = pTileset->NextSiblingElement("tileset");
+
+            layer.FirstBatch = this->_tileBatches.size();
+            for(int i = layer.Begin; i < layer.End; i++){
+                bool found = false;
+                for(int b = layer.FirstBatch; b < this->_tileBatches.size() && !found; b++){
+                    found = this->_tileBatches[b].getTexture() == p_tiles[i].getTileset();
+                }
+                if(!found){
+                    this->_tileBatches.push_back(TileBatch(p_tiles[i].getTileset()));
+                }
+            }
+            layer.BatchCount = this->_tileBatches.size() - layer.FirstBatch;
         }
+    };
+    indexLayers(this->_animatedTileList, this->_animatedTileLayers);
+
+    this->_tileChunkCache = TileChunkCache(this->getPixelSize(), TILE_CHUNK_SIZE);
+    this->_tileChunkCache.build(this->_tileSize);
+}
+
+void Level::invalidateTiles(const Rectangle &p_area){
+    this->_tileChunkCache.invalidate(p_area);
+}
+
+void Level::invalidateTileCache(){
+    this->_tileChunkCache.invalidateAll();
+}
+
+uint32_t Level::getTile(int p_layer, int p_x, int p_y) const {
+    if(p_layer < 0 || p_layer >= this->_tileGrid.getLayerCount() || !this->_tileGrid.contains(p_x, p_y)){
+        return 0;
     }
+    return this->_tileGrid.getGid(p_layer, p_x, p_y);
+}
 
-    //Load the layers
-    XMLElement* pLayer = mapNode->FirstChildElement("layer");
-    if(pLayer != NULL){
-        while(pLayer){
-            //Loading data element
-            XMLElement* pData = pLayer->FirstChildElement("data");
-            if(pData != NULL){
-                while(pData){
-                    //Loading tile element
-                    XMLElement* pTile = pData->FirstChildElement("tile");
-                    if(pTile != NULL){
-                        int tileCounter = 0;
-                        while(pTile){
-                            //build each tile here
-                            //if gid is 0, there is no tile, continue
-                             if(pTile->IntAttribute("gid") == 0){
-                                tileCounter++;
-                                if(pTile->NextSiblingElement("tile")){
-                                    pTile = pTile->NextSiblingElement("tile");
-                                    continue;
-                                } else {
-                                    break; 
-                                }
-                             }
-
-                            int gid = pTile->IntAttribute("gid");
-                            Tileset tls;
-                            int closest = 0;
-                            for(int i = 0; i < this->_tilesets.size(); i++){
-                                if(this->_tilesets[i].FirstGid <= gid){
-                                    if(this->_tilesets[i].FirstGid > closest){
-                                        closest = this->_tilesets[i].FirstGid;
-                                        tls = this->_tilesets[i];
-                                    }
-                                }
-                            }
-                            if(tls.FirstGid == -1){
-                                tileCounter++;
-                                if(pTile->NextSiblingElement("tile")){
-                                    pTile = pTile->NextSiblingElement("tile");
-                                    continue;
-                                } else { // means were done
-                                    break;
-                                }
-                            }
-                            // get the position of the tile in the level
-                            int xx = 0;
-                            int yy = 0;
-
-                            xx = tileCounter % width;
-                            xx *= tileWidth;
-
-                            yy += tileHeight * (tileCounter / width);
-
-                            Vector2f finalTilePos = Vector2f(xx, yy);
-
-                            //calculate the position of the tile in its tileset
-                            Vector2f finalTileSetPos = this->getTilesetPosition(tls, gid, tileWidth, tileHeight);
-
-                            //build the tile and add it to the level's tile list
-                            bool isAnimatedTile = false;
-                            AnimatedTileInfo ati;
-
-                            for(int i = 0; i < this->_animatedTileInfo.size(); i++){
-                                if(this->_animatedTileInfo[i].StartTileId == gid){
-                                    ati = this->_animatedTileInfo[i];
-                                    isAnimatedTile = true;
-                                    break;
-                                }
-                            }
-
-                            if(isAnimatedTile){
-                                std::vector<Vector2f> tilesetPositions;
-                                for(int i = 0; i < ati.TileIds.size(); i++){
-                                    tilesetPositions.push_back(this->getTilesetPosition(tls, ati.TileIds[i],
-                                        tileWidth, tileHeight));
-                                } // moved this out of the for loop
-                                AnimatedTile tile(tilesetPositions, ati.Duration, tls.Texture,
-                                    Vector2f(tileWidth, tileHeight), finalTilePos);
-                                this->_animatedTileList.push_back(tile);
-                            } else {
-                            Tile tile(tls.Texture, Vector2f(tileWidth, tileHeight),
-                                finalTileSetPos, finalTilePos);
-                            this->_tileList.push_back(tile);
-                            }
-                            tileCounter++;
-
-                            pTile = pTile->NextSiblingElement("tile");
-                        }
-                    }
-                    pData = pData->NextSiblingElement("data");
-                }
+void Level::setTile(int p_layer, int p_x, int p_y, uint32_t p_gid){
+    if(p_layer < 0 || p_layer >= this->_tileGrid.getLayerCount() || !this->_tileGrid.contains(p_x, p_y)){
+        return;
+    }
+    //the collision layer is never drawn, so its gids never animate
+    bool collisionLayer = this->_template->Map->Layers[p_layer].Collision;
+    TileGid previous = this->_template->getGid(this->_tileGrid.getGid(p_layer, p_x, p_y));
+    if(previous.Animation != -1 && !collisionLayer){
+        this->removeAnimatedTile(p_layer, p_x, p_y);
+    }
+    this->_tileGrid.setGid(p_layer, p_x, p_y, p_gid);
+    TileGid gid = this->_template->getGid(p_gid);
+    if(gid.Animation != -1 && gid.Tileset != -1 && !collisionLayer){
+        this->insertAnimatedTile(p_layer, p_x, p_y, p_gid);
+    }
+    this->updateSolidity(p_x, p_y);
+
+    int tileWidth = this->_tileSize.x * globals::SPRITE_SCALE;
+    int tileHeight = this->_tileSize.y * globals::SPRITE_SCALE;
+    this->invalidateTiles(Rectangle(p_x * tileWidth, p_y * tileHeight, tileWidth - 1, tileHeight - 1));
+}
+
+void Level::insertAnimatedTile(int p_layer, int p_x, int p_y, uint32_t p_gid){
+    TileGid gid = this->_template->getGid(p_gid);
+    AnimatedTile tile(this->_template->AnimationFrames[gid.Animation], this->_animatedTileInfo[gid.Animation].Duration,
+        this->_tilesets[gid.Tileset].Texture.get(), this->_tileSize, Vector2f(p_x * this->_tileSize.x, p_y * this->_tileSize.y));
+
+    //the row's tiles are sorted by x, which the culled drawing relies on
+    TileLayerRange &layer = this->_animatedTileLayers[p_layer];
+    std::vector<AnimatedTile>::iterator end = this->_animatedTileList.begin() + layer.RowStarts[p_y + 1];
+    std::vector<AnimatedTile>::iterator position = std::lower_bound(this->_animatedTileList.begin() + layer.RowStarts[p_y], end,
+        tile.getPosition().x, [](const AnimatedTile &p_tile, int p_x){ return p_tile.getPosition().x < p_x; });
+    this->_animatedTileList.insert(position, tile);
+    this->shiftAnimatedTiles(p_layer, p_y, 1);
+
+    //a tileset the layer didn't animate yet gets its own batch, after the layer's other batches
+    for(int b = layer.FirstBatch; b < layer.FirstBatch + layer.BatchCount; b++){
+        if(this->_tileBatches[b].getTexture() == tile.getTileset()){
+            return;
+        }
+    }
+    this->_tileBatches.insert(this->_tileBatches.begin() + layer.FirstBatch + layer.BatchCount, TileBatch(tile.getTileset()));
+    layer.BatchCount++;
+    for(int l = p_layer + 1; l < this->_animatedTileLayers.size(); l++){
+        this->_animatedTileLayers[l].FirstBatch++;
+    }
+}
+
+void Level::removeAnimatedTile(int p_layer, int p_x, int p_y){
+    TileLayerRange &layer = this->_animatedTileLayers[p_layer];
+    int x = p_x * this->_tileSize.x * globals::SPRITE_SCALE;
+    for(int i = layer.RowStarts[p_y]; i < layer.RowStarts[p_y + 1]; i++){
+        if(this->_animatedTileList[i].getPosition().x == x){
+            this->_animatedTileList.erase(this->_animatedTileList.begin() + i);
+            this->shiftAnimatedTiles(p_layer, p_y, -1);
+            return;
+        }
+    }
+}
+
+void Level::shiftAnimatedTiles(int p_layer, int p_row, int p_delta){
+    TileLayerRange &layer = this->_animatedTileLayers[p_layer];
+    for(int row = p_row + 1; row < layer.RowStarts.size(); row++){
+        layer.RowStarts[row] += p_delta;
+    }
+    layer.End += p_delta;
+
+    //the later layers' tiles all moved along
+    for(int l = p_layer + 1; l < this->_animatedTileLayers.size(); l++){
+        TileLayerRange &next = this->_animatedTileLayers[l];
+        for(int row = 0; row < next.RowStarts.size(); row++){
+            next.RowStarts[row] += p_delta;
+        }
+        next.Begin += p_delta;
+        next.End += p_delta;
+    }
+}
+
+void Level::updateSolidity(int p_x, int p_y){
+    if(this->_collisionMask.getWidth() == 0){
+        return;
+    }
+    //the grid holds animated gids too, so this sees the same tiles the level was built from
+    const MapData &map = *this->_template->Map;
+    bool solid = false;
+    for(int l = 0; l < this->_tileGrid.getLayerCount() && !solid; l++){
+        solid = this->_template->isSolid(this->_tileGrid.getGid(l, p_x, p_y), map.Layers[l].Collision);
+    }
+    this->_collisionMask.setSolid(p_x, p_y, solid);
+}
+
+void Level::buildCollisionGrids(){
+    Vector2f cellSize = Vector2f(this->_tileSize.x * globals::SPRITE_SCALE, this->_tileSize.y * globals::SPRITE_SCALE);
+    Vector2f worldSize = Vector2f(this->_size.x * cellSize.x, this->_size.y * cellSize.y);
+
+    this->_collisionGrid = SpatialGrid(cellSize, worldSize);
+    for(int i = 0; i < this->_collisionRects.size(); i++){
+        this->_collisionGrid.insert(this->_collisionRects[i]);
+    }
+
+    this->_slopeGrid = SpatialGrid(cellSize, worldSize);
+    for(int i = 0; i < this->_slopes.size(); i++){
+        Vector2f p1 = this->_slopes[i].getP1();
+        Vector2f p2 = this->_slopes[i].getP2();
+        this->_slopeGrid.insert(Rectangle(std::min(p1.x, p2.x), std::min(p1.y, p2.y),
+            std::abs(p2.x - p1.x), std::abs(p2.y - p1.y)));
+    }
+
+    this->_doorGrid = SpatialGrid(cellSize, worldSize);
+    for(int i = 0; i < this->_doorList.size(); i++){
+        this->_doorGrid.insert(this->_doorList[i].getRectangle());
+    }
+
+    this->_enemyGrid = SpatialGrid(cellSize, worldSize);
+    for(int i = 0; i < this->_enemies.size(); i++){
+        this->_enemyGrid.insert(this->_enemies[i]->getBoundingBox());
+    }
+}
+
+void Level::buildFromTemplate(const LevelTemplate &p_template, Graphics &p_graphics, bool p_buildTiles){
+    const MapData &map = *p_template.Map;
+    this->_size = map.Size;
+    this->_tileSize = map.TileSize;
+    this->_spawnPoint = map.SpawnPoint;
+    this->_animatedTileInfo = map.Animations;
+    int width = std::max(this->_size.x, 1);
+    Vector2f tileSize = this->_tileSize;
+
+    //infinite maps are flattened into a dense grid, streamed ones only get their solid cells
+    bool solidTiles = map.hasSolidTiles();
+    if(solidTiles){
+        this->_collisionMask = CollisionMask(this->_size.x, this->_size.y);
+    }
+    if(p_buildTiles){
+        this->_tileGrid = TileGrid(this->_size.x, this->_size.y, map.Layers.size());
+    } else if(solidTiles){
+        this->buildStreamedCollisionMask(p_template);
+    }
+    std::vector<uint32_t> gids;
+    for(int l = 0; l < map.Layers.size() && p_buildTiles; l++){
+        bool collisionLayer = map.Layers[l].Collision;
+        map.getLayerGids(l, gids);
+        for(int tileCounter = 0; tileCounter < gids.size(); tileCounter++){
+            int x = tileCounter % width;
+            int y = tileCounter / width;
+            if(solidTiles && p_template.isSolid(gids[tileCounter], collisionLayer)){
+                this->_collisionMask.setSolid(x, y, true);
+            }
+
+            //if gid is 0 or no tileset covers it, there is no tile; any tile of the collision layer counts
+            TileGid gid = p_template.getGid(gids[tileCounter]);
+            if(gids[tileCounter] == 0 || (gid.Tileset == -1 && !collisionLayer)){
+                continue;
+            }
+
+            //every tile keeps its gid, animated ones also need their own frame state
+            bool animated = gid.Animation != -1 && !collisionLayer;
+            if(this->_tileGrid.contains(x, y)){
+                this->_tileGrid.setGid(l, x, y, gids[tileCounter]);
+            }
+            if(!animated){
+                continue;
             }
-            pLayer = pLayer->NextSiblingElement("layer");
+            this->_animatedTileList.push_back(AnimatedTile(p_template.AnimationFrames[gid.Animation],
+                this->_animatedTileInfo[gid.Animation].Duration, p_template.Tilesets[gid.Tileset].Texture.get(),
+                tileSize, Vector2f(x * tileSize.x, y * tileSize.y)));
         }
+
+        //each layer's animated tiles were added row by row, which is what the culled drawing relies on
+        TileLayerRange layer = TileLayerRange();
+        layer.Begin = this->_animatedTileLayers.empty() ? 0 : this->_animatedTileLayers.back().End;
+        layer.End = this->_animatedTileList.size();
+        this->_animatedTileLayers.push_back(layer);
     }
 
-    //parse the collisions
-    XMLElement* pObjectGroup = mapNode->FirstChildElement("objectgroup");
-    if(pObjectGroup != NULL){
-        while(pObjectGroup){
-            const char* name = pObjectGroup->Attribute("name");
-            std::stringstream ss;
-            ss << name;
-            if(ss.str() == "collisions"){
-                XMLElement* pObject = pObjectGroup->FirstChildElement("object");
-                if(pObject != NULL){
-                    while(pObject){
-                        float x, y, width, height;
-                        x = pObject->FloatAttribute("x");
-                        y = pObject->FloatAttribute("y");
-                        width = pObject->FloatAttribute("width");
-                        height = pObject->FloatAttribute("height");
-                        this->_collisionRects.push_back(Rectangle(
-                            std::ceil(x) * globals::SPRITE_SCALE,
-                            std::ceil(y) * globals::SPRITE_SCALE,
-                            std::ceil(width) * globals::SPRITE_SCALE,
-                            std::ceil(height) * globals::SPRITE_SCALE
-                        ));
-                        pObject = pObject->NextSiblingElement("object");
-                    }
-                } 
-            } else if(ss.str() == "slopes"){
-                XMLElement* pObject = pObjectGroup->FirstChildElement("object");
-                if(pObject != NULL){
-                    while(pObject){
-                        std::vector<Vector2f> points;
-                        Vector2f p1;
-                        p1 = Vector2f(std::ceil(pObject->FloatAttribute("x")), std::ceil(pObject->FloatAttribute("y")));
-
-                        XMLElement* pPolyline = pObject->FirstChildElement("polyline");
-                        if(pPolyline != NULL){
-                            std::vector<std::string> pairs;
-                            const char* pointString = pPolyline->Attribute("points");
-
-                            std::stringstream ss;
-                            ss << pointString;
-
-                            Utils::split(ss.str(), pairs, ' ');
-
-                            for(int i = 0; i < pairs.size(); i++){
-                                std::vector<std::string> ps;
-                                Utils::split(pairs.at(i), ps, ',');
-                                points.push_back(Vector2f(std::stoi(ps.at(0)), std::stoi(ps.at(1))));
-                            }
-                        }
-
-                        for(int i = 0; i < points.size(); i+= 2){
-                            this->_slopes.push_back(Slope(
-                                Vector2f((p1.x + points.at(i < 2 ? i : i - 1).x) * globals::SPRITE_SCALE,
-                                        (p1.y + points.at(i < 2 ? i : i - 1).y) * globals::SPRITE_SCALE),
-                                Vector2f((p1.x + points.at(i < 2 ? i + 1 : i).x) * globals::SPRITE_SCALE,
-                                        (p1.y + points.at(i < 2 ? i + 1 : i).y) * globals::SPRITE_SCALE)
-                                ));
-                        }
-                        pObject = pObject->NextSiblingElement("object");
-                    }
-                } 
-            } else if(ss.str() == "spawn points"){
-                XMLElement* pObject = pObjectGroup->FirstChildElement("object");
-                if(pObject != NULL){
-                    while(pObject){
-                        float x = pObject->FloatAttribute("x");
-                        float y = pObject->FloatAttribute("y");
-                        const char* name = pObject->Attribute("name");
-                        std::stringstream ss;
-                        ss << name;
-                        if(ss.str() == "player"){
-                            this->_spawnPoint = Vector2f(std::ceil(x) * globals::SPRITE_SCALE, std::ceil(y) * globals::SPRITE_SCALE);
-                        }
-                        pObject = pObject->NextSiblingElement("object");
-                    }
-                }
-            } else if(ss.str() == "doors"){
-                XMLElement* pObject = pObjectGroup->FirstChildElement("object");
-                if(pObject != NULL){
-                    while(pObject){
-                        float x = pObject->FloatAttribute("x");
-                        float y = pObject->FloatAttribute("y");
-                        float w = pObject->FloatAttribute("width");
-                        float h = pObject->FloatAttribute("height");
-
-                        Rectangle rect = Rectangle(x, y, w, h);
-
-                        XMLElement* pProperties = pObject->FirstChildElement("properties");
-                        if(pProperties != NULL){
-                            while(pProperties){
-                                XMLElement* pProperty = pProperties->FirstChildElement("property");
-                                if(pProperty != NULL){
-                                    while(pProperty){
-                                        const char* name = pProperty->Attribute("name");
-                                        std::stringstream ss;
-                                        ss << name;
-                                        if(ss.str() == "destination"){
-                                            const char* value = pProperty->Attribute("value");
-                                            std::stringstream ss2;
-                                            ss2 << value;
-                                            Door door = Door(rect, ss2.str());
-                                            this->_doorList.push_back(door);
-                                        }
-                                        pProperty = pProperty->NextSiblingElement("property");
-                                    }
-                                }
-                                pProperties = pProperties->NextSiblingElement("properties");
-                            }
-                        }
-                        pObject = pObject->NextSiblingElement("object");
-                    }
-                }
-            } else if(ss.str() == "enemies"){
-                float x, y;
-                XMLElement* pObject = pObjectGroup->FirstChildElement("object");
-                if(pObject != NULL){
-                    while(pObject){
-                        x = pObject->FloatAttribute("x");
-                        y = pObject->FloatAttribute("y");
-                        const char* name = pObject->Attribute("name");
-                        std::stringstream ss;
-                        ss << name;
-                        if(ss.str() == "bat"){
-                            this->_enemies.push_back(new Bat(p_graphics,
-                                Vector2f(std::floor(x) * globals::SPRITE_SCALE,
-                                std::floor(y) * globals::SPRITE_SCALE)));
-                        }
-                        pObject = pObject->NextSiblingElement("object");
-                    }
+    this->_collisionRects = map.CollisionRects;
+    this->_slopes = map.Slopes;
+
+    for(int i = 0; i < map.Doors.size(); i++){
+        this->_doorList.push_back(Door(map.Doors[i].Rect, map.Doors[i].Destination));
+    }
+
+    for(int i = 0; i < map.Enemies.size(); i++){
+        if(map.Enemies[i].Name == "bat"){
+            this->_enemies.push_back(std::unique_ptr<Enemy>(new Bat(p_graphics, map.Enemies[i].Position)));
+        }
+    }
+
+    this->buildTileLayers();
+    this->buildCollisionGrids();
+}
+
+void Level::buildStreamedCollisionMask(const LevelTemplate &p_template){
+    const MapData &map = *p_template.Map;
+    std::vector<uint32_t> gids;
+    for(int l = 0; l < map.Layers.size(); l++){
+        //only the collision layer and the layers of a map with solid tiles can mark a cell solid
+        const LayerData &layer = map.Layers[l];
+        if(!layer.Collision && map.SolidGids.empty()){
+            continue;
+        }
+        for(int c = 0; c < layer.Chunks.size(); c++){
+            const ChunkData &chunk = layer.Chunks[c];
+            if(chunk.Width <= 0 || !MapData::decodeChunk(chunk, gids)){
+                printf("\nError: Unable to decode a chunk at %d, %d\n", chunk.X, chunk.Y);
+                continue;
+            }
+            for(int i = 0; i < gids.size(); i++){
+                if(p_template.isSolid(gids[i], layer.Collision)){
+                    this->_collisionMask.setSolid(chunk.X + i % chunk.Width, chunk.Y + i / chunk.Width, true);
                 }
             }
-            pObjectGroup = pObjectGroup->NextSiblingElement("objectgroup");
         }
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,249 @@
+#include <SDL2/SDL.h>
+#include <cstdio>
+
+#include "levelCache.h"
+#include "graphics.h"
+
+#include <algorithm>
+
+namespace{
+    Vector2f getTilesetPosition(int p_gid, int p_firstGid, int p_columns, Vector2f p_tileSize){
+        if(p_columns <= 0){
+            return Vector2f(0, 0);
+        }
+        return Vector2f(((p_gid - 1) % p_columns) * p_tileSize.x, ((p_gid - p_firstGid) / p_columns) * p_tileSize.y);
+    }
+
+    /**
+     * @brief Fills the gid lookup table and animation frames of a template whose tilesets are loaded.
+     */
+    void buildGidTable(LevelTemplate &p_template){
+        const MapData &map = *p_template.Map;
+        const std::vector<Tileset> &tilesets = p_template.Tilesets;
+
+        //tilesets by first gid; on a tie the earlier one in the file wins, and first gids below 1 never match
+        std::vector<int> order;
+        for(int i = 0; i < tilesets.size(); i++){
+            if(tilesets[i].FirstGid > 0){
+                order.push_back(i);
+            }
+        }
+        std::stable_sort(order.begin(), order.end(), [&tilesets](int p_a, int p_b){
+            return tilesets[p_a].FirstGid < tilesets[p_b].FirstGid;
+        });
+        for(int i = order.size() - 1; i > 0; i--){
+            if(tilesets[order[i]].FirstGid == tilesets[order[i - 1]].FirstGid){
+                order.erase(order.begin() + i);
+            }
+        }
+        p_template.LastTileset = order.empty() ? -1 : order.back();
+
+        int gidCount = map.SourcePositions.size();
+        for(int i = 0; i < tilesets.size(); i++){
+            int width = 0, height = 0;
+            if(tilesets[i].Texture){
+                SDL_QueryTexture(tilesets[i].Texture.get(), NULL, NULL, &width, &height);
+            }
+            p_template.TilesetColumns.push_back(map.TileSize.x > 0 ? width / map.TileSize.x : 0);
+            int rows = map.TileSize.y > 0 ? height / map.TileSize.y : 0;
+            gidCount = std::max(gidCount, tilesets[i].FirstGid + p_template.TilesetColumns[i] * rows);
+        }
+        for(int i = 0; i < map.Animations.size(); i++){
+            gidCount = std::max(gidCount, map.Animations[i].StartTileId + 1);
+        }
+        for(int i = 0; i < map.SolidGids.size(); i++){
+            gidCount = std::max(gidCount, (int)map.SolidGids[i] + 1);
+        }
+
+        TileGid empty;
+        empty.Tileset = -1;
+        empty.SourcePosition = Vector2f(0, 0);
+        empty.Animation = -1;
+        empty.Solid = false;
+        p_template.Gids.assign(std::max(gidCount, 1), empty);
+
+        //each tileset covers the gids from its first gid up to the next tileset's
+        for(int o = 0; o < order.size(); o++){
+            int tileset = order[o];
+            int end = o + 1 < order.size() ? std::min(tilesets[order[o + 1]].FirstGid, gidCount) : gidCount;
+            for(int gid = tilesets[tileset].FirstGid; gid < end; gid++){
+                TileGid &entry = p_template.Gids[gid];
+                entry.Tileset = tileset;
+                entry.SourcePosition = gid < map.SourcePositions.size() ? map.SourcePositions[gid] :
+                    getTilesetPosition(gid, tilesets[tileset].FirstGid, p_template.TilesetColumns[tileset], map.TileSize);
+            }
+        }
+
+        //an animation is found by its first tile, the first one listed wins
+        p_template.AnimationFrames.resize(map.Animations.size());
+        for(int a = map.Animations.size() - 1; a >= 0; a--){
+            const AnimatedTileInfo &ati = map.Animations[a];
+            if(ati.StartTileId <= 0){
+                continue;
+            }
+            TileGid &entry = p_template.Gids[ati.StartTileId];
+            entry.Animation = a;
+            if(entry.Tileset == -1){
+                continue;
+            }
+            //every frame is taken from the tileset of the animation's first tile
+            const Tileset &tileset = tilesets[entry.Tileset];
+            for(int f = 0; f < ati.TileIds.size(); f++){
+                int frame = ati.TileIds[f];
+                p_template.AnimationFrames[a].push_back(frame > 0 && frame < map.SourcePositions.size() ?
+                    map.SourcePositions[frame] :
+                    getTilesetPosition(frame, tileset.FirstGid, p_template.TilesetColumns[entry.Tileset], map.TileSize));
+            }
+        }
+
+        for(int i = 0; i < map.SolidGids.size(); i++){
+            if(map.SolidGids[i] > 0){
+                p_template.Gids[map.SolidGids[i]].Solid = true;
+            }
+        }
+    }
+}
+
+TileGid LevelTemplate::getGid(int p_gid) const {
+    if(p_gid > 0 && p_gid < this->Gids.size()){
+        return this->Gids[p_gid];
+    }
+
+    TileGid entry;
+    entry.Tileset = p_gid > 0 ? this->LastTileset : -1;
+    entry.SourcePosition = Vector2f(0, 0);
+    entry.Animation = -1;
+    entry.Solid = false;
+    if(entry.Tileset != -1){
+        entry.SourcePosition = getTilesetPosition(p_gid, this->Tilesets[entry.Tileset].FirstGid,
+            this->TilesetColumns[entry.Tileset], this->Map->TileSize);
+    }
+    return entry;
+}
+
+bool LevelTemplate::isSolid(uint32_t p_gid, bool p_collisionLayer) const {
+    if(p_gid == 0){
+        return false;
+    }
+    TileGid gid = this->getGid(p_gid);
+    return p_collisionLayer || (gid.Solid && gid.Tileset != -1);
+}
+
+LevelCache::LevelCache(size_t p_maxBytes):
+    _maxBytes(p_maxBytes),
+    _bytes(0),
+    _hits(0),
+    _misses(0),
+    _streamingRadius(0),
+    _tileDrawMode(tiledraw::BATCHED)
+{}
+
+void LevelTemplate::appendTile(uint32_t p_gid, Vector2f p_position, std::vector<Tile> &p_tiles,
+        std::vector<AnimatedTile> &p_animatedTiles) const {
+    TileGid gid = this->getGid(p_gid);
+    if(gid.Tileset == -1){
+        return;
+    }
+    SDL_Texture* texture = this->Tilesets[gid.Tileset].Texture.get();
+    if(gid.Animation != -1){
+        p_animatedTiles.push_back(AnimatedTile(this->AnimationFrames[gid.Animation],
+            this->Map->Animations[gid.Animation].Duration, texture, this->Map->TileSize, p_position));
+    } else {
+        p_tiles.push_back(Tile(texture, this->Map->TileSize, gid.SourcePosition, p_position));
+    }
+}
+
+std::shared_ptr<const LevelTemplate> LevelCache::getTemplate(const std::string &p_mapName, Graphics &p_graphics){
+    std::map<std::string, Entry>::iterator it = this->_entries.find(p_mapName);
+    if(it != this->_entries.end()){
+        //move the map to the front of the use order
+        this->_useOrder.splice(this->_useOrder.begin(), this->_useOrder, it->second.Use);
+        this->_hits++;
+        return it->second.Template;
+    }
+
+    this->_misses++;
+    std::shared_ptr<LevelTemplate> levelTemplate = this->loadTemplate(p_mapName, p_graphics);
+    if(!levelTemplate){
+        //failed loads aren't cached so the map is tried again next time
+        printf("\nError: Unable to load map %s\n", p_mapName.c_str());
+        levelTemplate = std::make_shared<LevelTemplate>();
+        levelTemplate->Name = p_mapName;
+        levelTemplate->Map = std::make_shared<MapData>();
+        levelTemplate->Bytes = 0;
+        return levelTemplate;
+    }
+
+    this->insert(levelTemplate);
+    return levelTemplate;
+}
+
+void LevelCache::insert(const std::shared_ptr<const LevelTemplate> &p_template){
+    if(this->contains(p_template->Name)){
+        return;
+    }
+    this->_useOrder.push_front(p_template->Name);
+    Entry entry;
+    entry.Template = p_template;
+    entry.Use = this->_useOrder.begin();
+    this->_entries[p_template->Name] = entry;
+    this->_bytes += p_template->Bytes;
+    this->evict();
+}
+
+Level LevelCache::createLevel(const std::string &p_mapName, Graphics &p_graphics){
+    Level level(this->getTemplate(p_mapName, p_graphics), p_graphics, this->_streamingRadius);
+    level.setTileDrawMode(this->_tileDrawMode);
+    return level;
+}
+
+bool LevelCache::contains(const std::string &p_mapName) const {
+    return this->_entries.count(p_mapName) > 0;
+}
+
+void LevelCache::clear(){
+    this->_entries.clear();
+    this->_useOrder.clear();
+    this->_bytes = 0;
+}
+
+std::shared_ptr<LevelTemplate> LevelCache::loadTemplate(const std::string &p_mapName, Graphics &p_graphics){
+    std::shared_ptr<MapData> map = std::make_shared<MapData>();
+    if(!MapData::load(p_mapName, *map)){
+        return std::shared_ptr<LevelTemplate>();
+    }
+
+    std::vector<Tileset> tilesets;
+    for(int i = 0; i < map->Tilesets.size(); i++){
+        tilesets.push_back(Tileset(p_graphics.loadTexture(map->Tilesets[i].ImagePath), map->Tilesets[i].FirstGid));
+    }
+    return LevelCache::makeTemplate(p_mapName, map, tilesets);
+}
+
+std::shared_ptr<LevelTemplate> LevelCache::makeTemplate(const std::string &p_mapName,
+        const std::shared_ptr<const MapData> &p_map, const std::vector<Tileset> &p_tilesets){
+    std::shared_ptr<LevelTemplate> levelTemplate = std::make_shared<LevelTemplate>();
+    levelTemplate->Name = p_mapName;
+    levelTemplate->Map = p_map;
+    levelTemplate->Tilesets = p_tilesets;
+    buildGidTable(*levelTemplate);
+
+    levelTemplate->Bytes = p_map->getMemorySize() + levelTemplate->Gids.capacity() * sizeof(TileGid);
+    for(int i = 0; i < p_tilesets.size(); i++){
+        int width = 0, height = 0;
+        if(p_tilesets[i].Texture){
+            SDL_QueryTexture(p_tilesets[i].Texture.get(), NULL, NULL, &width, &height);
+        }
+        levelTemplate->Bytes += width * height * 4;
+    }
+    return levelTemplate;
+}
+
+void LevelCache::evict(){
+    while(this->_bytes > this->_maxBytes && this->_useOrder.size() > 1){
+        std::map<std::string, Entry>::iterator it = this->_entries.find(this->_useOrder.back());
+        this->_bytes -= it->second.Template->Bytes;
+        this->_entries.erase(it);
+        this->_useOrder.pop_back();
+    }
+}
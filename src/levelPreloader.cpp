@@ -0,0 +1,112 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <cstdio>
+
+#include "levelPreloader.h"
+#include "levelCache.h"
+#include "graphics.h"
+
+LevelPreloader::LevelPreloader():
+    _stopping(false)
+{
+    this->_worker = std::thread(&LevelPreloader::run, this);
+}
+
+LevelPreloader::~LevelPreloader(){
+    {
+        std::lock_guard<std::mutex> lock(this->_mutex);
+        this->_stopping = true;
+    }
+    this->_wakeUp.notify_one();
+    this->_worker.join();
+
+    for(int i = 0; i < this->_finished.size(); i++){
+        for(int s = 0; s < this->_finished[i].Surfaces.size(); s++){
+            if(this->_finished[i].Surfaces[s] != NULL){
+                SDL_FreeSurface(this->_finished[i].Surfaces[s]);
+            }
+        }
+    }
+}
+
+void LevelPreloader::request(const std::string &p_mapName){
+    {
+        std::lock_guard<std::mutex> lock(this->_mutex);
+        if(!this->_pending.insert(p_mapName).second){
+            return;
+        }
+        this->_queue.push_back(p_mapName);
+    }
+    this->_wakeUp.notify_one();
+}
+
+bool LevelPreloader::isPending(const std::string &p_mapName){
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    return this->_pending.count(p_mapName) > 0;
+}
+
+int LevelPreloader::poll(LevelCache &p_levelCache, Graphics &p_graphics){
+    //take the finished loads out under the lock, the uploads happen without holding it
+    std::vector<LoadedMap> finished;
+    {
+        std::lock_guard<std::mutex> lock(this->_mutex);
+        if(this->_finished.empty()){
+            return 0;
+        }
+        finished.swap(this->_finished);
+        for(int i = 0; i < finished.size(); i++){
+            this->_pending.erase(finished[i].Name);
+        }
+    }
+
+    int added = 0;
+    for(int i = 0; i < finished.size(); i++){
+        LoadedMap &loaded = finished[i];
+        if(!loaded.Map){
+            printf("\nError: Unable to preload map %s\n", loaded.Name.c_str());
+            continue;
+        }
+
+        //uploadTexture frees every surface, including the ones whose texture was already live
+        std::vector<Tileset> tilesets;
+        for(int t = 0; t < loaded.Map->Tilesets.size(); t++){
+            const TilesetData &tileset = loaded.Map->Tilesets[t];
+            tilesets.push_back(Tileset(p_graphics.uploadTexture(tileset.ImagePath, loaded.Surfaces[t]), tileset.FirstGid));
+        }
+
+        //a level entered while it was loading is already cached, the cache keeps the first one
+        if(!p_levelCache.contains(loaded.Name)){
+            p_levelCache.insert(LevelCache::makeTemplate(loaded.Name, loaded.Map, tilesets));
+            added++;
+        }
+    }
+    return added;
+}
+
+void LevelPreloader::run(){
+    while(true){
+        std::string mapName;
+        {
+            std::unique_lock<std::mutex> lock(this->_mutex);
+            this->_wakeUp.wait(lock, [this](){ return this->_stopping || !this->_queue.empty(); });
+            if(this->_stopping){
+                return;
+            }
+            mapName = this->_queue.front();
+            this->_queue.pop_front();
+        }
+
+        LoadedMap loaded;
+        loaded.Name = mapName;
+        std::shared_ptr<MapData> map = std::make_shared<MapData>();
+        if(MapData::load(mapName, *map)){
+            loaded.Map = map;
+            for(int i = 0; i < map->Tilesets.size(); i++){
+                loaded.Surfaces.push_back(IMG_Load(map->Tilesets[i].ImagePath.c_str()));
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(this->_mutex);
+        this->_finished.push_back(loaded);
+    }
+}
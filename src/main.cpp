@@ -1,5 +1,7 @@
 #include <SDL2/SDL.h>
+#include <cstdlib>
 #include <iostream>
+#include <string>
 
 #include "game.h"
 
@@ -8,6 +10,48 @@ int WinMain(int argc, const char* argv[]){
 #else
 int main(int argc, const char* argv[]){
 #endif
-    Game game;
-    return 0;
+    GameOptions options;
+    for(int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        if(arg == "--tick-rate" && i + 1 < argc){
+            options.TickRate = std::atoi(argv[++i]);
+        } else if(arg == "--vsync"){
+            options.Pacing = pacing::VSYNC;
+        } else if(arg == "--fps" && i + 1 < argc){
+            options.Pacing = pacing::LIMITED;
+            options.TargetFps = std::atoi(argv[++i]);
+        } else if(arg == "--uncapped"){
+            options.Pacing = pacing::UNCAPPED;
+        } else if(arg == "--stream" && i + 1 < argc){
+            options.StreamRadius = std::atoi(argv[++i]);
+        } else if(arg == "--tile-mode" && i + 1 < argc){
+            std::string mode = argv[++i];
+            if(mode == "per-tile"){
+                options.TileDrawMode = tiledraw::PER_TILE;
+            } else if(mode == "batched"){
+                options.TileDrawMode = tiledraw::BATCHED;
+            } else if(mode == "cached"){
+                options.TileDrawMode = tiledraw::CACHED;
+            } else {
+                std::cout << "Unknown tile mode: " << mode << ", expected per-tile, batched or cached" << std::endl;
+            }
+        } else if(arg == "--headless"){
+            options.Headless = true;
+        } else if(arg == "--ticks" && i + 1 < argc){
+            options.Ticks = std::strtoull(argv[++i], NULL, 10);
+        } else if(arg == "--record" && i + 1 < argc){
+            options.RecordPath = argv[++i];
+        } else if(arg == "--replay" && i + 1 < argc){
+            options.ReplayPath = argv[++i];
+        } else if(arg == "--map" && i + 1 < argc){
+            options.StartMap = argv[++i];
+        } else if(arg == "--perf-overlay"){
+            options.PerfOverlay = true;
+        } else {
+            std::cout << "Unknown option: " << arg << std::endl;
+        }
+    }
+
+    Game game(options);
+    return game.hasFailed() ? 1 : 0;
 }
\ No newline at end of file
@@ -0,0 +1,806 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "mapData.h"
+#include "tinyxml2.h"
+#include "utils.h"
+#include "tmxEncoding.h"
+
+using namespace tinyxml2;
+
+namespace{
+    const char COOKED_MAGIC[4] = {'C', 'S', 'M', 'P'};
+    const std::string MAP_DIRECTORY = "../res/maps/";
+
+    /**
+     * @class MappedFile
+     * @brief Read only view of a whole file, mapped into memory for as long as the object lives.
+     */
+    class MappedFile {
+    public:
+        MappedFile(const std::string &p_filePath):
+            _data(NULL),
+            _size(0)
+        {
+#ifdef _WIN32
+            this->_file = CreateFileA(p_filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+            this->_mapping = NULL;
+            if(this->_file == INVALID_HANDLE_VALUE){
+                return;
+            }
+            LARGE_INTEGER size;
+            if(!GetFileSizeEx(this->_file, &size) || size.QuadPart == 0){
+                return;
+            }
+            this->_mapping = CreateFileMappingA(this->_file, NULL, PAGE_READONLY, 0, 0, NULL);
+            if(this->_mapping == NULL){
+                return;
+            }
+            this->_data = (const unsigned char*)MapViewOfFile(this->_mapping, FILE_MAP_READ, 0, 0, 0);
+            if(this->_data != NULL){
+                this->_size = (size_t)size.QuadPart;
+            }
+#else
+            int fd = open(p_filePath.c_str(), O_RDONLY);
+            if(fd < 0){
+                return;
+            }
+            struct stat info;
+            if(fstat(fd, &info) == 0 && info.st_size > 0){
+                void* data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if(data != MAP_FAILED){
+                    this->_data = (const unsigned char*)data;
+                    this->_size = info.st_size;
+                }
+            }
+            //the mapping stays valid after the descriptor is closed
+            close(fd);
+#endif
+        }
+
+        ~MappedFile(){
+#ifdef _WIN32
+            if(this->_data != NULL){
+                UnmapViewOfFile(this->_data);
+            }
+            if(this->_mapping != NULL){
+                CloseHandle(this->_mapping);
+            }
+            if(this->_file != INVALID_HANDLE_VALUE){
+                CloseHandle(this->_file);
+            }
+#else
+            if(this->_data != NULL){
+                munmap((void*)this->_data, this->_size);
+            }
+#endif
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile &operator=(const MappedFile&) = delete;
+
+        const unsigned char* getData() const { return this->_data; }
+        size_t getSize() const { return this->_size; }
+
+    private:
+        const unsigned char* _data;
+        size_t _size;
+#ifdef _WIN32
+        HANDLE _file;
+        HANDLE _mapping;
+#endif
+    };
+
+    /**
+     * @class CookedReader
+     * @brief Bounds checked little endian reader over a cooked map.
+     *
+     * Any read past the end sets the reader as failed and returns zeros, so a truncated
+     * file is detected once at the end instead of after every field.
+     */
+    class CookedReader {
+    public:
+        CookedReader(const unsigned char* p_data, size_t p_size):
+            _pos(p_data),
+            _end(p_data + p_size),
+            _ok(true)
+        {}
+
+        uint32_t readU32(){
+            if(this->_end - this->_pos < 4){
+                this->_ok = false;
+                this->_pos = this->_end;
+                return 0;
+            }
+            uint32_t value = (uint32_t)this->_pos[0] | ((uint32_t)this->_pos[1] << 8) |
+                ((uint32_t)this->_pos[2] << 16) | ((uint32_t)this->_pos[3] << 24);
+            this->_pos += 4;
+            return value;
+        }
+
+        int readInt(){
+            return (int32_t)this->readU32();
+        }
+
+        //a count can't be larger than what is left of the file, which keeps a corrupt count from allocating gigabytes
+        uint32_t readCount(size_t p_minElementSize){
+            uint32_t count = this->readU32();
+            if(count > (size_t)(this->_end - this->_pos) / p_minElementSize){
+                this->_ok = false;
+                this->_pos = this->_end;
+                return 0;
+            }
+            return count;
+        }
+
+        std::string readString(){
+            uint32_t length = this->readCount(1);
+            std::string value((const char*)this->_pos, length);
+            this->_pos += length;
+            return value;
+        }
+
+        Vector2f readVector(){
+            int x = this->readInt();
+            int y = this->readInt();
+            return Vector2f(x, y);
+        }
+
+        Rectangle readRectangle(){
+            int x = this->readInt();
+            int y = this->readInt();
+            int w = this->readInt();
+            int h = this->readInt();
+            return Rectangle(x, y, w, h);
+        }
+
+        bool isOk() const { return this->_ok; }
+
+    private:
+        const unsigned char* _pos;
+        const unsigned char* _end;
+        bool _ok;
+    };
+
+    /**
+     * @class CookedWriter
+     * @brief Little endian writer building a cooked map in memory.
+     */
+    class CookedWriter {
+    public:
+        void writeU32(uint32_t p_value){
+            this->_bytes.push_back(p_value & 0xFF);
+            this->_bytes.push_back((p_value >> 8) & 0xFF);
+            this->_bytes.push_back((p_value >> 16) & 0xFF);
+            this->_bytes.push_back((p_value >> 24) & 0xFF);
+        }
+
+        void writeInt(int p_value){
+            this->writeU32((uint32_t)p_value);
+        }
+
+        void writeString(const std::string &p_value){
+            this->writeU32(p_value.size());
+            this->_bytes.insert(this->_bytes.end(), p_value.begin(), p_value.end());
+        }
+
+        void writeVector(Vector2f p_value){
+            this->writeInt(p_value.x);
+            this->writeInt(p_value.y);
+        }
+
+        void writeRectangle(const Rectangle &p_value){
+            this->writeInt(p_value.getLeft());
+            this->writeInt(p_value.getTop());
+            this->writeInt(p_value.getWidth());
+            this->writeInt(p_value.getHeight());
+        }
+
+        void writeBytes(const char* p_data, size_t p_size){
+            this->_bytes.insert(this->_bytes.end(), p_data, p_data + p_size);
+        }
+
+        const std::vector<char> &getBytes() const { return this->_bytes; }
+
+    private:
+        std::vector<char> _bytes;
+    };
+
+    std::string getAttribute(const XMLElement* p_element, const char* p_name){
+        const char* value = p_element->Attribute(p_name);
+        return value != NULL ? std::string(value) : std::string();
+    }
+
+    std::string getProperty(const XMLElement* p_element, const char* p_name){
+        const XMLElement* pProperties = p_element->FirstChildElement("properties");
+        if(pProperties == NULL){
+            return std::string();
+        }
+        for(const XMLElement* pProperty = pProperties->FirstChildElement("property"); pProperty != NULL;
+                pProperty = pProperty->NextSiblingElement("property")){
+            if(getAttribute(pProperty, "name") == p_name){
+                return getAttribute(pProperty, "value");
+            }
+        }
+        return std::string();
+    }
+}
+
+MapData::MapData():
+    Size(Vector2f(0, 0)),
+    TileSize(Vector2f(0, 0)),
+    SpawnPoint(Vector2f(0, 0)),
+    Infinite(false),
+    Origin(Vector2f(0, 0))
+{}
+
+bool MapData::load(const std::string &p_mapName, MapData &p_map){
+    std::string tmxPath = MAP_DIRECTORY + p_mapName + ".tmx";
+    std::string cookedPath = MAP_DIRECTORY + p_mapName + ".cmap";
+
+    //a cooked file older than its .tmx is stale (the map was edited after cooking), so it is ignored
+    std::error_code error;
+    if(std::filesystem::exists(cookedPath, error)){
+        std::filesystem::file_time_type cookedTime = std::filesystem::last_write_time(cookedPath, error);
+        std::filesystem::file_time_type tmxTime = std::filesystem::last_write_time(tmxPath, error);
+        bool stale = !error && tmxTime > cookedTime;
+        if(!stale && MapData::loadCooked(cookedPath, p_map)){
+            return true;
+        }
+    }
+    return MapData::loadTmx(tmxPath, p_map);
+}
+
+bool MapData::loadTmx(const std::string &p_filePath, MapData &p_map){
+    XMLDocument doc;
+    if(doc.LoadFile(p_filePath.c_str()) != XML_SUCCESS){
+        return false;
+    }
+
+    XMLElement* mapNode = doc.FirstChildElement("map");
+    if(mapNode == NULL){
+        return false;
+    }
+
+    p_map = MapData();
+    p_map.Size = Vector2f(mapNode->IntAttribute("width"), mapNode->IntAttribute("height"));
+    p_map.TileSize = Vector2f(mapNode->IntAttribute("tilewidth"), mapNode->IntAttribute("tileheight"));
+    p_map.Infinite = mapNode->IntAttribute("infinite") != 0;
+
+    //tilesets and the animations of their tiles
+    for(XMLElement* pTileset = mapNode->FirstChildElement("tileset"); pTileset != NULL;
+            pTileset = pTileset->NextSiblingElement("tileset")){
+        TilesetData tileset;
+        tileset.FirstGid = pTileset->IntAttribute("firstgid");
+        tileset.ImageWidth = 0;
+        tileset.ImageHeight = 0;
+        XMLElement* pImage = pTileset->FirstChildElement("image");
+        if(pImage != NULL){
+            tileset.ImagePath = getAttribute(pImage, "source");
+            tileset.ImageWidth = pImage->IntAttribute("width");
+            tileset.ImageHeight = pImage->IntAttribute("height");
+        }
+        p_map.Tilesets.push_back(tileset);
+
+        for(XMLElement* pTile = pTileset->FirstChildElement("tile"); pTile != NULL;
+                pTile = pTile->NextSiblingElement("tile")){
+            if(getProperty(pTile, "solid") == "true" || getProperty(pTile, "solid") == "1"){
+                p_map.SolidGids.push_back(pTile->IntAttribute("id") + tileset.FirstGid);
+            }
+
+            XMLElement* pAnimation = pTile->FirstChildElement("animation");
+            if(pAnimation == NULL){
+                continue;
+            }
+            AnimatedTileInfo ati;
+            ati.StartTileId = pTile->IntAttribute("id") + tileset.FirstGid;
+            ati.TilesetsFirstGid = tileset.FirstGid;
+            ati.Duration = 0;
+            for(XMLElement* pFrame = pAnimation->FirstChildElement("frame"); pFrame != NULL;
+                    pFrame = pFrame->NextSiblingElement("frame")){
+                ati.TileIds.push_back(pFrame->IntAttribute("tileid") + tileset.FirstGid);
+                ati.Duration = pFrame->IntAttribute("duration");
+            }
+            p_map.Animations.push_back(ati);
+        }
+    }
+
+    //tile layers, one gid per cell in map order
+    for(XMLElement* pLayer = mapNode->FirstChildElement("layer"); pLayer != NULL;
+            pLayer = pLayer->NextSiblingElement("layer")){
+        LayerData layer;
+        std::string layerName = getAttribute(pLayer, "name");
+        layer.Collision = layerName == "collision" || layerName == "collisions";
+        size_t cellCount = (size_t)pLayer->IntAttribute("width", p_map.Size.x) * pLayer->IntAttribute("height", p_map.Size.y);
+        for(XMLElement* pData = pLayer->FirstChildElement("data"); pData != NULL;
+                pData = pData->NextSiblingElement("data")){
+            std::string encoding = getAttribute(pData, "encoding");
+            if(p_map.Infinite){
+                //chunks stay encoded until they're needed, only the legacy form is read right away
+                for(XMLElement* pChunk = pData->FirstChildElement("chunk"); pChunk != NULL;
+                        pChunk = pChunk->NextSiblingElement("chunk")){
+                    ChunkData chunk;
+                    chunk.X = pChunk->IntAttribute("x");
+                    chunk.Y = pChunk->IntAttribute("y");
+                    chunk.Width = pChunk->IntAttribute("width");
+                    chunk.Height = pChunk->IntAttribute("height");
+                    if(encoding.empty()){
+                        for(XMLElement* pTile = pChunk->FirstChildElement("tile"); pTile != NULL;
+                                pTile = pTile->NextSiblingElement("tile")){
+                            chunk.Gids.push_back(pTile->UnsignedAttribute("gid"));
+                        }
+                        chunk.Gids.resize((size_t)std::max(chunk.Width, 0) * std::max(chunk.Height, 0));
+                    } else {
+                        chunk.Encoding = encoding;
+                        chunk.Compression = getAttribute(pData, "compression");
+                        chunk.Payload = pChunk->GetText() != NULL ? pChunk->GetText() : "";
+                    }
+                    layer.Chunks.push_back(chunk);
+                }
+            } else if(encoding.empty()){
+                //legacy form, one <tile> element per cell
+                for(XMLElement* pTile = pData->FirstChildElement("tile"); pTile != NULL;
+                        pTile = pTile->NextSiblingElement("tile")){
+                    layer.Gids.push_back(pTile->UnsignedAttribute("gid"));
+                }
+            } else if(!tmxEncoding::decodeGids(pData->GetText(), encoding, getAttribute(pData, "compression"),
+                    cellCount, layer.Gids)){
+                printf("\nError: Unable to decode layer %s of %s (encoding %s, compression %s)\n",
+                    getAttribute(pLayer, "name").c_str(), p_filePath.c_str(), encoding.c_str(),
+                    getAttribute(pData, "compression").c_str());
+                return false;
+            }
+        }
+        p_map.Layers.push_back(layer);
+    }
+
+    //object groups
+    for(XMLElement* pObjectGroup = mapNode->FirstChildElement("objectgroup"); pObjectGroup != NULL;
+            pObjectGroup = pObjectGroup->NextSiblingElement("objectgroup")){
+        std::string groupName = getAttribute(pObjectGroup, "name");
+        for(XMLElement* pObject = pObjectGroup->FirstChildElement("object"); pObject != NULL;
+                pObject = pObject->NextSiblingElement("object")){
+            float x = pObject->FloatAttribute("x");
+            float y = pObject->FloatAttribute("y");
+
+            if(groupName == "collisions"){
+                p_map.CollisionRects.push_back(Rectangle(
+                    std::ceil(x) * globals::SPRITE_SCALE,
+                    std::ceil(y) * globals::SPRITE_SCALE,
+                    std::ceil(pObject->FloatAttribute("width")) * globals::SPRITE_SCALE,
+                    std::ceil(pObject->FloatAttribute("height")) * globals::SPRITE_SCALE
+                ));
+            } else if(groupName == "slopes"){
+                std::vector<Vector2f> points;
+                Vector2f p1 = Vector2f(std::ceil(x), std::ceil(y));
+
+                XMLElement* pPolyline = pObject->FirstChildElement("polyline");
+                if(pPolyline != NULL){
+                    std::vector<std::string> pairs;
+                    Utils::split(getAttribute(pPolyline, "points"), pairs, ' ');
+                    for(int i = 0; i < pairs.size(); i++){
+                        std::vector<std::string> ps;
+                        Utils::split(pairs.at(i), ps, ',');
+                        points.push_back(Vector2f(std::stoi(ps.at(0)), std::stoi(ps.at(1))));
+                    }
+                }
+
+                for(int i = 0; i < points.size(); i += 2){
+                    p_map.Slopes.push_back(Slope(
+                        Vector2f((p1.x + points.at(i < 2 ? i : i - 1).x) * globals::SPRITE_SCALE,
+                                (p1.y + points.at(i < 2 ? i : i - 1).y) * globals::SPRITE_SCALE),
+                        Vector2f((p1.x + points.at(i < 2 ? i + 1 : i).x) * globals::SPRITE_SCALE,
+                                (p1.y + points.at(i < 2 ? i + 1 : i).y) * globals::SPRITE_SCALE)
+                        ));
+                }
+            } else if(groupName == "spawn points"){
+                if(getAttribute(pObject, "name") == "player"){
+                    p_map.SpawnPoint = Vector2f(std::ceil(x) * globals::SPRITE_SCALE, std::ceil(y) * globals::SPRITE_SCALE);
+                }
+            } else if(groupName == "doors"){
+                Rectangle rect = Rectangle(x, y, pObject->FloatAttribute("width"), pObject->FloatAttribute("height"));
+                for(XMLElement* pProperties = pObject->FirstChildElement("properties"); pProperties != NULL;
+                        pProperties = pProperties->NextSiblingElement("properties")){
+                    for(XMLElement* pProperty = pProperties->FirstChildElement("property"); pProperty != NULL;
+                            pProperty = pProperty->NextSiblingElement("property")){
+                        if(getAttribute(pProperty, "name") == "destination"){
+                            DoorData door;
+                            door.Rect = rect;
+                            door.Destination = getAttribute(pProperty, "value");
+                            p_map.Doors.push_back(door);
+                        }
+                    }
+                }
+            } else if(groupName == "enemies"){
+                EnemyData enemy;
+                enemy.Name = getAttribute(pObject, "name");
+                enemy.Position = Vector2f(std::floor(x) * globals::SPRITE_SCALE, std::floor(y) * globals::SPRITE_SCALE);
+                p_map.Enemies.push_back(enemy);
+            }
+        }
+    }
+
+    if(p_map.Infinite){
+        p_map.placeChunks();
+    }
+    p_map.computeSourcePositions();
+    return true;
+}
+
+void MapData::placeChunks(){
+    //the chunks' bounds become the map, so nothing downstream deals with negative tiles
+    bool first = true;
+    int left = 0, top = 0, right = 0, bottom = 0;
+    for(int l = 0; l < this->Layers.size(); l++){
+        for(int c = 0; c < this->Layers[l].Chunks.size(); c++){
+            const ChunkData &chunk = this->Layers[l].Chunks[c];
+            left = first ? chunk.X : std::min(left, chunk.X);
+            top = first ? chunk.Y : std::min(top, chunk.Y);
+            right = first ? chunk.X + chunk.Width : std::max(right, chunk.X + chunk.Width);
+            bottom = first ? chunk.Y + chunk.Height : std::max(bottom, chunk.Y + chunk.Height);
+            first = false;
+        }
+    }
+    this->Origin = Vector2f(left, top);
+    this->Size = Vector2f(right - left, bottom - top);
+
+    for(int l = 0; l < this->Layers.size(); l++){
+        for(int c = 0; c < this->Layers[l].Chunks.size(); c++){
+            this->Layers[l].Chunks[c].X -= left;
+            this->Layers[l].Chunks[c].Y -= top;
+        }
+    }
+
+    //objects are in map pixels from tile (0, 0), move them by the same amount as the tiles
+    int dx = left * this->TileSize.x;
+    int dy = top * this->TileSize.y;
+    int scaledDx = dx * globals::SPRITE_SCALE;
+    int scaledDy = dy * globals::SPRITE_SCALE;
+    this->SpawnPoint = Vector2f(this->SpawnPoint.x - scaledDx, this->SpawnPoint.y - scaledDy);
+    for(int i = 0; i < this->CollisionRects.size(); i++){
+        const Rectangle &rect = this->CollisionRects[i];
+        this->CollisionRects[i] = Rectangle(rect.getLeft() - scaledDx, rect.getTop() - scaledDy, rect.getWidth(), rect.getHeight());
+    }
+    for(int i = 0; i < this->Slopes.size(); i++){
+        Vector2f p1 = this->Slopes[i].getP1();
+        Vector2f p2 = this->Slopes[i].getP2();
+        this->Slopes[i] = Slope(Vector2f(p1.x - scaledDx, p1.y - scaledDy), Vector2f(p2.x - scaledDx, p2.y - scaledDy));
+    }
+    for(int i = 0; i < this->Doors.size(); i++){
+        const Rectangle &rect = this->Doors[i].Rect;
+        this->Doors[i].Rect = Rectangle(rect.getLeft() - dx, rect.getTop() - dy, rect.getWidth(), rect.getHeight());
+    }
+    for(int i = 0; i < this->Enemies.size(); i++){
+        this->Enemies[i].Position = Vector2f(this->Enemies[i].Position.x - scaledDx, this->Enemies[i].Position.y - scaledDy);
+    }
+}
+
+bool MapData::decodeChunk(const ChunkData &p_chunk, std::vector<uint32_t> &p_gids){
+    if(p_chunk.Encoding.empty()){
+        p_gids = p_chunk.Gids;
+        return true;
+    }
+    size_t cellCount = (size_t)std::max(p_chunk.Width, 0) * std::max(p_chunk.Height, 0);
+    return tmxEncoding::decodeGids(p_chunk.Payload.c_str(), p_chunk.Encoding, p_chunk.Compression, cellCount, p_gids);
+}
+
+void MapData::getLayerGids(int p_layer, std::vector<uint32_t> &p_gids) const {
+    const LayerData &layer = this->Layers[p_layer];
+    if(!this->Infinite){
+        p_gids = layer.Gids;
+        return;
+    }
+
+    p_gids.assign((size_t)this->Size.x * this->Size.y, 0);
+    std::vector<uint32_t> chunkGids;
+    for(int c = 0; c < layer.Chunks.size(); c++){
+        const ChunkData &chunk = layer.Chunks[c];
+        if(chunk.X < 0 || chunk.Y < 0 || chunk.X + chunk.Width > this->Size.x || chunk.Y + chunk.Height > this->Size.y){
+            continue;
+        }
+        if(!MapData::decodeChunk(chunk, chunkGids)){
+            printf("\nError: Unable to decode a chunk at %d, %d\n", chunk.X, chunk.Y);
+            continue;
+        }
+        for(int y = 0; y < chunk.Height; y++){
+            std::copy(chunkGids.begin() + y * chunk.Width, chunkGids.begin() + (y + 1) * chunk.Width,
+                p_gids.begin() + (size_t)(chunk.Y + y) * this->Size.x + chunk.X);
+        }
+    }
+}
+
+void MapData::computeSourcePositions(){
+    this->SourcePositions.clear();
+    if(this->TileSize.x <= 0 || this->TileSize.y <= 0){
+        return;
+    }
+
+    //only worth it when every tileset's image size is known, otherwise the level asks the textures
+    int gidCount = 0;
+    for(int i = 0; i < this->Tilesets.size(); i++){
+        const TilesetData &tileset = this->Tilesets[i];
+        int columns = tileset.ImageWidth / this->TileSize.x;
+        int rows = tileset.ImageHeight / this->TileSize.y;
+        if(columns <= 0 || rows <= 0){
+            return;
+        }
+        gidCount = std::max(gidCount, tileset.FirstGid + columns * rows);
+    }
+
+    this->SourcePositions.assign(gidCount, Vector2f(0, 0));
+    for(int gid = 1; gid < gidCount; gid++){
+        //same tileset pick and position math as the level uses for textures
+        const TilesetData* tileset = NULL;
+        int closest = 0;
+        for(int i = 0; i < this->Tilesets.size(); i++){
+            if(this->Tilesets[i].FirstGid <= gid && this->Tilesets[i].FirstGid > closest){
+                closest = this->Tilesets[i].FirstGid;
+                tileset = &this->Tilesets[i];
+            }
+        }
+        if(tileset == NULL){
+            continue;
+        }
+        int columns = tileset->ImageWidth / this->TileSize.x;
+        this->SourcePositions[gid] = Vector2f(((gid - 1) % columns) * this->TileSize.x,
+            ((gid - tileset->FirstGid) / columns) * this->TileSize.y);
+    }
+}
+
+size_t MapData::getMemorySize() const {
+    size_t bytes = sizeof(MapData);
+    for(int i = 0; i < this->Tilesets.size(); i++){
+        bytes += sizeof(TilesetData) + this->Tilesets[i].ImagePath.capacity();
+    }
+    for(int i = 0; i < this->Animations.size(); i++){
+        bytes += sizeof(AnimatedTileInfo) + this->Animations[i].TileIds.capacity() * sizeof(int);
+    }
+    for(int i = 0; i < this->Layers.size(); i++){
+        bytes += sizeof(LayerData) + this->Layers[i].Gids.capacity() * sizeof(uint32_t);
+        for(int c = 0; c < this->Layers[i].Chunks.size(); c++){
+            const ChunkData &chunk = this->Layers[i].Chunks[c];
+            bytes += sizeof(ChunkData) + chunk.Payload.capacity() + chunk.Gids.capacity() * sizeof(uint32_t);
+        }
+    }
+    bytes += this->SolidGids.capacity() * sizeof(uint32_t);
+    bytes += this->SourcePositions.capacity() * sizeof(Vector2f);
+    bytes += this->CollisionRects.capacity() * sizeof(Rectangle);
+    bytes += this->Slopes.capacity() * sizeof(Slope);
+    for(int i = 0; i < this->Doors.size(); i++){
+        bytes += sizeof(DoorData) + this->Doors[i].Destination.capacity();
+    }
+    for(int i = 0; i < this->Enemies.size(); i++){
+        bytes += sizeof(EnemyData) + this->Enemies[i].Name.capacity();
+    }
+    return bytes;
+}
+
+bool MapData::hasSolidTiles() const {
+    if(!this->SolidGids.empty()){
+        return true;
+    }
+    for(int i = 0; i < this->Layers.size(); i++){
+        if(this->Layers[i].Collision){
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MapData::loadCooked(const std::string &p_filePath, MapData &p_map){
+    MappedFile file(p_filePath);
+    if(file.getData() == NULL || file.getSize() < sizeof(COOKED_MAGIC) ||
+            std::memcmp(file.getData(), COOKED_MAGIC, sizeof(COOKED_MAGIC)) != 0){
+        return false;
+    }
+
+    CookedReader reader(file.getData() + sizeof(COOKED_MAGIC), file.getSize() - sizeof(COOKED_MAGIC));
+    if(reader.readU32() != COOKED_VERSION){
+        return false;
+    }
+
+    MapData map;
+    map.Size = reader.readVector();
+    map.TileSize = reader.readVector();
+    map.SpawnPoint = reader.readVector();
+    map.Infinite = reader.readU32() != 0;
+    map.Origin = reader.readVector();
+
+    map.Tilesets.resize(reader.readCount(16));
+    for(int i = 0; i < map.Tilesets.size(); i++){
+        map.Tilesets[i].ImagePath = reader.readString();
+        map.Tilesets[i].FirstGid = reader.readInt();
+        map.Tilesets[i].ImageWidth = reader.readInt();
+        map.Tilesets[i].ImageHeight = reader.readInt();
+    }
+
+    map.Animations.resize(reader.readCount(16));
+    for(int i = 0; i < map.Animations.size(); i++){
+        AnimatedTileInfo &ati = map.Animations[i];
+        ati.TilesetsFirstGid = reader.readInt();
+        ati.StartTileId = reader.readInt();
+        ati.Duration = reader.readInt();
+        ati.TileIds.resize(reader.readCount(4));
+        for(int f = 0; f < ati.TileIds.size(); f++){
+            ati.TileIds[f] = reader.readInt();
+        }
+    }
+
+    map.SolidGids.resize(reader.readCount(4));
+    for(int i = 0; i < map.SolidGids.size(); i++){
+        map.SolidGids[i] = reader.readU32();
+    }
+
+    map.SourcePositions.resize(reader.readCount(8));
+    for(int i = 0; i < map.SourcePositions.size(); i++){
+        map.SourcePositions[i] = reader.readVector();
+    }
+
+    map.Layers.resize(reader.readCount(12));
+    for(int i = 0; i < map.Layers.size(); i++){
+        map.Layers[i].Collision = reader.readU32() != 0;
+        std::vector<uint32_t> &gids = map.Layers[i].Gids;
+        gids.resize(reader.readCount(4));
+        for(int g = 0; g < gids.size(); g++){
+            gids[g] = reader.readU32();
+        }
+
+        std::vector<ChunkData> &chunks = map.Layers[i].Chunks;
+        chunks.resize(reader.readCount(32));
+        for(int c = 0; c < chunks.size(); c++){
+            chunks[c].X = reader.readInt();
+            chunks[c].Y = reader.readInt();
+            chunks[c].Width = reader.readInt();
+            chunks[c].Height = reader.readInt();
+            chunks[c].Encoding = reader.readString();
+            chunks[c].Compression = reader.readString();
+            chunks[c].Payload = reader.readString();
+            chunks[c].Gids.resize(reader.readCount(4));
+            for(int g = 0; g < chunks[c].Gids.size(); g++){
+                chunks[c].Gids[g] = reader.readU32();
+            }
+        }
+    }
+
+    map.CollisionRects.resize(reader.readCount(16));
+    for(int i = 0; i < map.CollisionRects.size(); i++){
+        map.CollisionRects[i] = reader.readRectangle();
+    }
+
+    map.Slopes.resize(reader.readCount(16));
+    for(int i = 0; i < map.Slopes.size(); i++){
+        Vector2f p1 = reader.readVector();
+        Vector2f p2 = reader.readVector();
+        map.Slopes[i] = Slope(p1, p2);
+    }
+
+    map.Doors.resize(reader.readCount(20));
+    for(int i = 0; i < map.Doors.size(); i++){
+        map.Doors[i].Rect = reader.readRectangle();
+        map.Doors[i].Destination = reader.readString();
+    }
+
+    map.Enemies.resize(reader.readCount(12));
+    for(int i = 0; i < map.Enemies.size(); i++){
+        map.Enemies[i].Name = reader.readString();
+        map.Enemies[i].Position = reader.readVector();
+    }
+
+    if(!reader.isOk()){
+        return false;
+    }
+    p_map = std::move(map);
+    return true;
+}
+
+bool MapData::saveCooked(const std::string &p_filePath) const {
+    CookedWriter writer;
+    writer.writeBytes(COOKED_MAGIC, sizeof(COOKED_MAGIC));
+    writer.writeU32(COOKED_VERSION);
+    writer.writeVector(this->Size);
+    writer.writeVector(this->TileSize);
+    writer.writeVector(this->SpawnPoint);
+    writer.writeU32(this->Infinite ? 1 : 0);
+    writer.writeVector(this->Origin);
+
+    writer.writeU32(this->Tilesets.size());
+    for(int i = 0; i < this->Tilesets.size(); i++){
+        writer.writeString(this->Tilesets[i].ImagePath);
+        writer.writeInt(this->Tilesets[i].FirstGid);
+        writer.writeInt(this->Tilesets[i].ImageWidth);
+        writer.writeInt(this->Tilesets[i].ImageHeight);
+    }
+
+    writer.writeU32(this->Animations.size());
+    for(int i = 0; i < this->Animations.size(); i++){
+        const AnimatedTileInfo &ati = this->Animations[i];
+        writer.writeInt(ati.TilesetsFirstGid);
+        writer.writeInt(ati.StartTileId);
+        writer.writeInt(ati.Duration);
+        writer.writeU32(ati.TileIds.size());
+        for(int f = 0; f < ati.TileIds.size(); f++){
+            writer.writeInt(ati.TileIds[f]);
+        }
+    }
+
+    writer.writeU32(this->SolidGids.size());
+    for(int i = 0; i < this->SolidGids.size(); i++){
+        writer.writeU32(this->SolidGids[i]);
+    }
+
+    writer.writeU32(this->SourcePositions.size());
+    for(int i = 0; i < this->SourcePositions.size(); i++){
+        writer.writeVector(this->SourcePositions[i]);
+    }
+
+    writer.writeU32(this->Layers.size());
+    for(int i = 0; i < this->Layers.size(); i++){
+        writer.writeU32(this->Layers[i].Collision ? 1 : 0);
+        const std::vector<uint32_t> &gids = this->Layers[i].Gids;
+        writer.writeU32(gids.size());
+        for(int g = 0; g < gids.size(); g++){
+            writer.writeU32(gids[g]);
+        }
+
+        const std::vector<ChunkData> &chunks = this->Layers[i].Chunks;
+        writer.writeU32(chunks.size());
+        for(int c = 0; c < chunks.size(); c++){
+            writer.writeInt(chunks[c].X);
+            writer.writeInt(chunks[c].Y);
+            writer.writeInt(chunks[c].Width);
+            writer.writeInt(chunks[c].Height);
+            writer.writeString(chunks[c].Encoding);
+            writer.writeString(chunks[c].Compression);
+            writer.writeString(chunks[c].Payload);
+            writer.writeU32(chunks[c].Gids.size());
+            for(int g = 0; g < chunks[c].Gids.size(); g++){
+                writer.writeU32(chunks[c].Gids[g]);
+            }
+        }
+    }
+
+    writer.writeU32(this->CollisionRects.size());
+    for(int i = 0; i < this->CollisionRects.size(); i++){
+        writer.writeRectangle(this->CollisionRects[i]);
+    }
+
+    writer.writeU32(this->Slopes.size());
+    for(int i = 0; i < this->Slopes.size(); i++){
+        writer.writeVector(this->Slopes[i].getP1());
+        writer.writeVector(this->Slopes[i].getP2());
+    }
+
+    writer.writeU32(this->Doors.size());
+    for(int i = 0; i < this->Doors.size(); i++){
+        writer.writeRectangle(this->Doors[i].Rect);
+        writer.writeString(this->Doors[i].Destination);
+    }
+
+    writer.writeU32(this->Enemies.size());
+    for(int i = 0; i < this->Enemies.size(); i++){
+        writer.writeString(this->Enemies[i].Name);
+        writer.writeVector(this->Enemies[i].Position);
+    }
+
+    std::ofstream out(p_filePath.c_str(), std::ios::binary | std::ios::trunc);
+    if(!out){
+        return false;
+    }
+    out.write(writer.getBytes().data(), writer.getBytes().size());
+    return out.good();
+}
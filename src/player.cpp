@@ -1,7 +1,11 @@
 #include "player.h"
 #include "graphics.h"
 #include "object.h"
+#include "camera.h"
+#include "profiler.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 namespace player_constants{
@@ -24,13 +28,13 @@ Player::Player(Graphics &p_graphics, Vector2f p_spawnPoint):
         _maxHealth(3),
         _currentHealth(3)
     {
-        p_graphics.loadImage("../res/gfx/MyChar.png");
         this->setupAnimations();
         this->playAnimation("IdleRight");
     }
 
-void Player::draw(Graphics &p_graphics){
-    AnimatedSprite::draw(p_graphics, this->_x, this ->_y);
+void Player::draw(Graphics &p_graphics, const Camera &p_camera, float p_alpha){
+    AnimatedSprite::draw(p_graphics, p_camera.toScreenX(this->getInterpolatedX(p_alpha)),
+        p_camera.toScreenY(this->getInterpolatedY(p_alpha)));
 }
 
 void Player::moveLeft(){
@@ -103,17 +107,75 @@ void Player::jump(){
 }
 
 
-void Player::update(float p_elapsedTime){
+void Player::update(float p_elapsedTime, Level &p_level){
+    PROFILE_ZONE("Player::update");
     //Apply gravity
     if(this->_dy <= player_constants::GRAVITY_CAP){
         this->_dy += player_constants::GRAVITY * p_elapsedTime;
     }
 
-    this->_x += _dx * p_elapsedTime;
-    this->_y += _dy * p_elapsedTime;
+    this->sweep(p_level, this->_dx * p_elapsedTime, true);
+    if(this->sweep(p_level, this->_dy * p_elapsedTime, false)){
+        //landed, or hit a ceiling
+        if(this->_dy > 0){
+            this->_grounded = true;
+        }
+        this->_dy = 0;
+    }
     AnimatedSprite::update(p_elapsedTime);
 }
 
+bool Player::sweep(Level &p_level, float p_distance, bool p_horizontal){
+    if(p_distance == 0.0f){
+        return false;
+    }
+    Rectangle box = Rectangle(this->_x, this->_y, this->_boundingBox.getWidth(), this->_boundingBox.getHeight());
+
+    //the broad phase is asked for everything the box crosses during the whole move
+    int reach = std::ceil(std::abs(p_distance));
+    int back = p_distance < 0 ? reach : 0;
+    Rectangle swept = p_horizontal ?
+        Rectangle(box.getLeft() - back, box.getTop(), box.getWidth() + reach, box.getHeight()) :
+        Rectangle(box.getLeft(), box.getTop() - back, box.getWidth(), box.getHeight() + reach);
+    p_level.checkTileCollisions(swept, this->_sweepHits);
+
+    //the nearest face ahead of the box is the time of impact, the box stops one pixel before it
+    float &position = p_horizontal ? this->_x : this->_y;
+    int size = p_horizontal ? box.getWidth() : box.getHeight();
+    float target = position + p_distance;
+    bool blocked = false;
+    for(int i = 0; i < this->_sweepHits.size(); i++){
+        const Rectangle &other = this->_sweepHits[i];
+        if(other.collidesWith(box)){
+            continue;
+        }
+        bool aside = p_horizontal ?
+            other.getTop() > box.getBottom() || other.getBottom() < box.getTop() :
+            other.getLeft() > box.getRight() || other.getRight() < box.getLeft();
+        if(aside){
+            continue;
+        }
+
+        if(p_distance > 0){
+            int face = p_horizontal ? other.getLeft() : other.getTop();
+            float stop = std::max((float)(face - size - 1), position);
+            if(face > (p_horizontal ? box.getRight() : box.getBottom()) && stop < target){
+                target = stop;
+                blocked = true;
+            }
+        } else {
+            int face = p_horizontal ? other.getRight() : other.getBottom();
+            float stop = std::min((float)(face + 1), position);
+            if(face < (p_horizontal ? box.getLeft() : box.getTop()) && stop > target){
+                target = stop;
+                blocked = true;
+            }
+        }
+    }
+    position = target;
+    return blocked;
+}
+
 void Player::animationDone(std::string p_currentAnimation){
 
 }
@@ -186,12 +248,13 @@ void Player::handleSlopeCollisions(std::vector<Slope> &p_others){
     }
 }
 
-void Player::handleDoorCollision(std::vector<Door> &p_others, Level &p_level, Graphics &p_graphics){
+void Player::handleDoorCollision(std::vector<Door> &p_others, Level &p_level, LevelCache &p_levelCache, Graphics &p_graphics){
     for(int i = 0; i < p_others.size(); i++){
         if(this->_grounded && this->_lookingDown){
-            p_level = Level(p_others.at(i).getDestination(), p_graphics);
+            p_level = p_levelCache.createLevel(p_others.at(i).getDestination(), p_graphics);
             this->_x = p_level.getPlayerSpawnPoint().x;
             this->_y = p_level.getPlayerSpawnPoint().y;
+            this->savePreviousPosition();
         }
     }
 }
@@ -206,12 +269,13 @@ void Player::gainHealth(int p_amount){
     this->_currentHealth += p_amount;
 }
 
-void Player::resetLevelOnDeath(Level &p_level, Graphics &p_graphics){
+void Player::resetLevelOnDeath(Level &p_level, LevelCache &p_levelCache, Graphics &p_graphics){
     if(this->_currentHealth == 0){
-        p_level = Level("Map 1", p_graphics);
+        p_level = p_levelCache.createLevel("Map 1", p_graphics);
 
         this->_x = p_level.getPlayerSpawnPoint().x;
         this->_y = p_level.getPlayerSpawnPoint().y;
+        this->savePreviousPosition();
 
         this->_currentHealth = this->_maxHealth;
 
@@ -0,0 +1,111 @@
+#ifdef ENABLE_PROFILER
+
+#include <cstdio>
+
+#include "profiler.h"
+
+namespace{
+    const int FRAME_CAPACITY = 1024; // frames kept, about 17 seconds at 60 FPS
+    const int ZONE_CAPACITY = 1 << 16; // zones kept, shared by those frames
+
+    /**
+     * @struct ZoneEvent
+     * @brief A finished zone.
+     */
+    struct ZoneEvent {
+        const char* Name; ///< Name of the zone.
+        Uint64 Start; ///< Performance counter when the zone began.
+        Uint64 End; ///< Performance counter when the zone ended.
+    };
+
+    /**
+     * @struct FrameEvent
+     * @brief A closed frame and the range of zones recorded during it.
+     */
+    struct FrameEvent {
+        Uint64 Start; ///< Performance counter when the frame began.
+        Uint64 End; ///< Performance counter when the frame was closed.
+        unsigned long long FirstZone; ///< Index of its first zone, counted since the program started.
+        unsigned long long ZoneCount; ///< Number of zones recorded during the frame.
+    };
+
+    ZoneEvent zones[ZONE_CAPACITY];
+    FrameEvent frames[FRAME_CAPACITY];
+    unsigned long long zoneCount = 0; // zones recorded since start, the ring slot is zoneCount % ZONE_CAPACITY
+    unsigned long long frameCount = 0;
+    unsigned long long frameFirstZone = 0;
+    Uint64 frameStart = 0;
+    unsigned long long droppedZones = 0;
+
+    double toMicroseconds(Uint64 p_counter, Uint64 p_origin){
+        return (double)(p_counter - p_origin) * 1000000.0 / SDL_GetPerformanceFrequency();
+    }
+}
+
+void profiler::record(const char* p_name, Uint64 p_start, Uint64 p_end){
+    //a frame can't hold more zones than the ring, or it would overwrite its own beginning
+    if(zoneCount - frameFirstZone >= ZONE_CAPACITY){
+        droppedZones++;
+        return;
+    }
+    if(frameStart == 0){
+        frameStart = p_start;
+    }
+    ZoneEvent &zone = zones[zoneCount % ZONE_CAPACITY];
+    zone.Name = p_name;
+    zone.Start = p_start;
+    zone.End = p_end;
+    zoneCount++;
+}
+
+void profiler::endFrame(){
+    Uint64 now = SDL_GetPerformanceCounter();
+    FrameEvent &frame = frames[frameCount % FRAME_CAPACITY];
+    frame.Start = frameStart != 0 ? frameStart : now;
+    frame.End = now;
+    frame.FirstZone = frameFirstZone;
+    frame.ZoneCount = zoneCount - frameFirstZone;
+    frameCount++;
+
+    frameFirstZone = zoneCount;
+    frameStart = now;
+}
+
+unsigned long long profiler::getFrameCount(){
+    return frameCount;
+}
+
+bool profiler::dump(const std::string &p_filePath){
+    FILE* file = std::fopen(p_filePath.c_str(), "w");
+    if(file == NULL){
+        printf("\nError: Unable to write the profile %s\n", p_filePath.c_str());
+        return false;
+    }
+
+    //frames are written oldest first, skipping those whose zones were overwritten since
+    unsigned long long firstFrame = frameCount > FRAME_CAPACITY ? frameCount - FRAME_CAPACITY : 0;
+    while(firstFrame < frameCount && frames[firstFrame % FRAME_CAPACITY].FirstZone + ZONE_CAPACITY < zoneCount){
+        firstFrame++;
+    }
+    Uint64 origin = firstFrame < frameCount ? frames[firstFrame % FRAME_CAPACITY].Start : 0;
+
+    std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"frames\":%llu,\"droppedZones\":%llu},\"traceEvents\":[\n",
+        frameCount - firstFrame, droppedZones);
+    std::fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"main\"}}");
+    for(unsigned long long f = firstFrame; f < frameCount; f++){
+        const FrameEvent &frame = frames[f % FRAME_CAPACITY];
+        std::fprintf(file, ",\n{\"name\":\"Frame\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f,"
+            "\"args\":{\"frame\":%llu}}", toMicroseconds(frame.Start, origin), toMicroseconds(frame.End, frame.Start), f);
+        for(unsigned long long z = frame.FirstZone; z < frame.FirstZone + frame.ZoneCount; z++){
+            const ZoneEvent &zone = zones[z % ZONE_CAPACITY];
+            std::fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"zone\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+                zone.Name, toMicroseconds(zone.Start, origin), toMicroseconds(zone.End, zone.Start));
+        }
+    }
+    std::fprintf(file, "\n]}\n");
+
+    bool written = std::ferror(file) == 0;
+    return std::fclose(file) == 0 && written;
+}
+
+#endif /* ENABLE_PROFILER */
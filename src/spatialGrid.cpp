@@ -0,0 +1,105 @@
+#include <algorithm>
+
+#include "spatialGrid.h"
+
+SpatialGrid::SpatialGrid():
+    _cellSize(Vector2f(1, 1)),
+    _columns(0),
+    _rows(0),
+    _queryStamp(0)
+{}
+
+SpatialGrid::SpatialGrid(Vector2f p_cellSize, Vector2f p_worldSize):
+    _cellSize(Vector2f(std::max(p_cellSize.x, 1), std::max(p_cellSize.y, 1))),
+    _queryStamp(0)
+{
+    this->_columns = std::max(1, (p_worldSize.x + this->_cellSize.x - 1) / this->_cellSize.x);
+    this->_rows = std::max(1, (p_worldSize.y + this->_cellSize.y - 1) / this->_cellSize.y);
+    this->_cells.resize(this->_columns * this->_rows);
+}
+
+void SpatialGrid::clear(){
+    for(int i = 0; i < this->_cells.size(); i++){
+        this->_cells[i].clear();
+    }
+    this->_spans.clear();
+    this->_stamps.clear();
+}
+
+int SpatialGrid::insert(const Rectangle &p_rect){
+    int id = this->_spans.size();
+    CellSpan span = this->getSpan(p_rect);
+    this->_spans.push_back(span);
+    this->_stamps.push_back(0);
+    this->updateCells(id, span, true);
+    return id;
+}
+
+void SpatialGrid::move(int p_id, const Rectangle &p_rect){
+    CellSpan span = this->getSpan(p_rect);
+    if(span == this->_spans[p_id]){
+        return;
+    }
+    this->updateCells(p_id, this->_spans[p_id], false);
+    this->updateCells(p_id, span, true);
+    this->_spans[p_id] = span;
+}
+
+void SpatialGrid::query(const Rectangle &p_rect, std::vector<int> &p_ids){
+    if(this->_cells.empty()){
+        return;
+    }
+
+    //a new stamp per query lets entries spanning several cells be reported once without clearing anything
+    this->_queryStamp++;
+    if(this->_queryStamp == 0){
+        std::fill(this->_stamps.begin(), this->_stamps.end(), 0);
+        this->_queryStamp = 1;
+    }
+
+    int first = p_ids.size();
+    CellSpan span = this->getSpan(p_rect);
+    for(int y = span.y0; y <= span.y1; y++){
+        for(int x = span.x0; x <= span.x1; x++){
+            const std::vector<int> &cell = this->_cells[y * this->_columns + x];
+            for(int i = 0; i < cell.size(); i++){
+                if(this->_stamps[cell[i]] != this->_queryStamp){
+                    this->_stamps[cell[i]] = this->_queryStamp;
+                    p_ids.push_back(cell[i]);
+                }
+            }
+        }
+    }
+    std::sort(p_ids.begin() + first, p_ids.end());
+}
+
+SpatialGrid::CellSpan SpatialGrid::getSpan(const Rectangle &p_rect) const{
+    //floor division so rectangles left/above the origin land in the first cells
+    auto toCell = [](int p_value, int p_size, int p_count){
+        int cell = p_value >= 0 ? p_value / p_size : -((-p_value + p_size - 1) / p_size);
+        return std::min(std::max(cell, 0), p_count - 1);
+    };
+
+    CellSpan span;
+    span.x0 = toCell(std::min(p_rect.getLeft(), p_rect.getRight()), this->_cellSize.x, this->_columns);
+    span.x1 = toCell(std::max(p_rect.getLeft(), p_rect.getRight()), this->_cellSize.x, this->_columns);
+    span.y0 = toCell(std::min(p_rect.getTop(), p_rect.getBottom()), this->_cellSize.y, this->_rows);
+    span.y1 = toCell(std::max(p_rect.getTop(), p_rect.getBottom()), this->_cellSize.y, this->_rows);
+    return span;
+}
+
+void SpatialGrid::updateCells(int p_id, const CellSpan &p_span, bool p_add){
+    if(this->_cells.empty()){
+        return;
+    }
+    for(int y = p_span.y0; y <= p_span.y1; y++){
+        for(int x = p_span.x0; x <= p_span.x1; x++){
+            std::vector<int> &cell = this->_cells[y * this->_columns + x];
+            if(p_add){
+                cell.push_back(p_id);
+            } else {
+                cell.erase(std::remove(cell.begin(), cell.end(), p_id), cell.end());
+            }
+        }
+    }
+}
@@ -2,6 +2,7 @@
 
 #include "tile.h"
 #include "graphics.h"
+#include "camera.h"
 
 Tile::Tile(){}
 
@@ -14,12 +15,12 @@ Tile::Tile(SDL_Texture* p_tileset, Vector2f p_size, Vector2f p_tilesetPosition,
 
 }
 
-void Tile::update(int p_elapsedTime){
+void Tile::update(float p_elapsedTime){
 
 }
 
-void Tile::draw(Graphics &p_graphics){
-    SDL_Rect dst = {this->_position.x, this->_position.y, 
+void Tile::draw(Graphics &p_graphics, const Camera &p_camera) const{
+    SDL_Rect dst = {p_camera.toScreenX(this->_position.x), p_camera.toScreenY(this->_position.y), 
     this->_size.x * globals::SPRITE_SCALE, this->_size.y * globals::SPRITE_SCALE};
     SDL_Rect src = {this->_tilesetPosition.x, this->_tilesetPosition.y, 
     this->_size.x, this->_size.y};
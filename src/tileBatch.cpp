@@ -0,0 +1,74 @@
+#include "tileBatch.h"
+#include "graphics.h"
+
+TileBatch::TileBatch():
+    _texture(NULL),
+    _textureWidth(1),
+    _textureHeight(1)
+{}
+
+TileBatch::TileBatch(SDL_Texture* p_texture):
+    _texture(p_texture),
+    _textureWidth(1),
+    _textureHeight(1)
+{
+    int width, height;
+    if(SDL_QueryTexture(p_texture, NULL, NULL, &width, &height) == 0 && width > 0 && height > 0){
+        this->_textureWidth = width;
+        this->_textureHeight = height;
+    }
+}
+
+int TileBatch::addTile(Vector2f p_tilesetPosition, Vector2f p_size, Vector2f p_position){
+    int quad = this->_vertices.size() / 4;
+    float left = p_position.x;
+    float top = p_position.y;
+    float right = left + p_size.x * globals::SPRITE_SCALE;
+    float bottom = top + p_size.y * globals::SPRITE_SCALE;
+
+    SDL_Vertex vertex;
+    vertex.color = {255, 255, 255, 255};
+    vertex.tex_coord = {0, 0};
+
+    vertex.position = {left, top};
+    this->_vertices.push_back(vertex);
+    vertex.position = {right, top};
+    this->_vertices.push_back(vertex);
+    vertex.position = {right, bottom};
+    this->_vertices.push_back(vertex);
+    vertex.position = {left, bottom};
+    this->_vertices.push_back(vertex);
+
+    int first = quad * 4;
+    int indices[6] = {first, first + 1, first + 2, first, first + 2, first + 3};
+    this->_indices.insert(this->_indices.end(), indices, indices + 6);
+
+    this->setTileSource(quad, p_tilesetPosition, p_size);
+    return quad;
+}
+
+void TileBatch::setTileSource(int p_quad, Vector2f p_tilesetPosition, Vector2f p_size){
+    float u0 = p_tilesetPosition.x / this->_textureWidth;
+    float v0 = p_tilesetPosition.y / this->_textureHeight;
+    float u1 = (p_tilesetPosition.x + p_size.x) / this->_textureWidth;
+    float v1 = (p_tilesetPosition.y + p_size.y) / this->_textureHeight;
+
+    SDL_Vertex* vertices = &this->_vertices[p_quad * 4];
+    vertices[0].tex_coord = {u0, v0};
+    vertices[1].tex_coord = {u1, v0};
+    vertices[2].tex_coord = {u1, v1};
+    vertices[3].tex_coord = {u0, v1};
+}
+
+void TileBatch::clear(){
+    this->_vertices.clear();
+    this->_indices.clear();
+}
+
+void TileBatch::draw(Graphics &p_graphics){
+    if(this->_indices.empty()){
+        return;
+    }
+    p_graphics.renderGeometry(this->_texture, this->_vertices.data(), this->_vertices.size(),
+        this->_indices.data(), this->_indices.size());
+}
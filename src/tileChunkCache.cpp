@@ -0,0 +1,211 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+
+#include "tileChunkCache.h"
+#include "graphics.h"
+#include "camera.h"
+#include "levelCache.h"
+
+TileChunkCache::TileChunkCache():
+    _chunkSize(1),
+    _tileSize(Vector2f(0, 0)),
+    _columns(0),
+    _rows(0)
+{}
+
+TileChunkCache::TileChunkCache(Vector2f p_worldSize, int p_chunkSize):
+    _chunkSize(std::max(p_chunkSize, 1)),
+    _tileSize(Vector2f(0, 0))
+{
+    this->_columns = std::max(1, (p_worldSize.x + this->_chunkSize - 1) / this->_chunkSize);
+    this->_rows = std::max(1, (p_worldSize.y + this->_chunkSize - 1) / this->_chunkSize);
+    this->_chunks.resize(this->_columns * this->_rows);
+}
+
+void TileChunkCache::build(Vector2f p_tileSize){
+    this->_tileSize = p_tileSize;
+    for(int i = 0; i < this->_chunks.size(); i++){
+        this->_chunks[i].Empty = false;
+        this->_chunks[i].Dirty = true;
+        this->_chunks[i].Failed = false;
+    }
+}
+
+void TileChunkCache::invalidate(const Rectangle &p_area){
+    if(this->_chunks.empty()){
+        return;
+    }
+    int x0 = std::max(0, p_area.getLeft() / this->_chunkSize);
+    int y0 = std::max(0, p_area.getTop() / this->_chunkSize);
+    int x1 = std::min(this->_columns - 1, p_area.getRight() / this->_chunkSize);
+    int y1 = std::min(this->_rows - 1, p_area.getBottom() / this->_chunkSize);
+    for(int y = y0; y <= y1; y++){
+        for(int x = x0; x <= x1; x++){
+            this->_chunks[y * this->_columns + x].Dirty = true;
+        }
+    }
+}
+
+void TileChunkCache::invalidateAll(){
+    //render targets may work again after a device reset, so failed chunks get another try
+    for(int i = 0; i < this->_chunks.size(); i++){
+        this->_chunks[i].Dirty = true;
+        this->_chunks[i].Failed = false;
+    }
+}
+
+void TileChunkCache::draw(Graphics &p_graphics, const Camera &p_camera, const TileGrid &p_grid, const LevelTemplate &p_template){
+    if(this->_chunks.empty()){
+        return;
+    }
+    Rectangle view = p_camera.getView();
+    int x0 = std::max(0, view.getLeft() / this->_chunkSize);
+    int y0 = std::max(0, view.getTop() / this->_chunkSize);
+    int x1 = std::min(this->_columns - 1, (view.getRight() - 1) / this->_chunkSize);
+    int y1 = std::min(this->_rows - 1, (view.getBottom() - 1) / this->_chunkSize);
+
+    for(int y = y0; y <= y1; y++){
+        for(int x = x0; x <= x1; x++){
+            int index = y * this->_columns + x;
+            Chunk &chunk = this->_chunks[index];
+            if(chunk.Dirty && !chunk.Failed){
+                this->renderChunk(p_graphics, index, p_grid, p_template);
+            }
+            if(chunk.Empty){
+                continue;
+            }
+            if(chunk.Failed){
+                this->drawChunkTiles(p_graphics, p_camera, index, p_grid, p_template);
+                continue;
+            }
+
+            SDL_Rect dst = {p_camera.toScreenX(x * this->_chunkSize), p_camera.toScreenY(y * this->_chunkSize),
+                this->_chunkSize, this->_chunkSize};
+            p_graphics.blitSurface(chunk.Texture.get(), NULL, &dst);
+        }
+    }
+}
+
+void TileChunkCache::renderChunk(Graphics &p_graphics, int p_index, const TileGrid &p_grid, const LevelTemplate &p_template){
+    Chunk &chunk = this->_chunks[p_index];
+    chunk.Dirty = false;
+    int firstColumn, firstRow, lastColumn, lastRow;
+    if(!this->getChunkCells(p_index, p_grid, firstColumn, firstRow, lastColumn, lastRow)){
+        chunk.Empty = true;
+        return;
+    }
+    int tileWidth = this->_tileSize.x * globals::SPRITE_SCALE;
+    int tileHeight = this->_tileSize.y * globals::SPRITE_SCALE;
+    int originX = (p_index % this->_columns) * this->_chunkSize;
+    int originY = (p_index / this->_columns) * this->_chunkSize;
+
+    //the collision layer is never drawn, and animated tiles are drawn live over the chunks
+    const std::vector<LayerData> &layers = p_template.Map->Layers;
+    chunk.Empty = true;
+    for(int l = 0; l < p_grid.getLayerCount() && chunk.Empty; l++){
+        if(layers[l].Collision){
+            continue;
+        }
+        for(int row = firstRow; row <= lastRow && chunk.Empty; row++){
+            const uint32_t* gids = p_grid.getRow(l, row);
+            for(int column = firstColumn; column <= lastColumn && chunk.Empty; column++){
+                chunk.Empty = gids[column] == 0 || p_template.getGid(gids[column]).Animation != -1;
+            }
+        }
+    }
+    if(chunk.Empty){
+        return;
+    }
+    if(!chunk.Texture){
+        chunk.Texture = p_graphics.createTargetTexture(this->_chunkSize, this->_chunkSize);
+        if(!chunk.Texture){
+            //rendering to a NULL target would clear and draw over the screen instead
+            chunk.Failed = true;
+            return;
+        }
+    }
+
+    p_graphics.beginRenderToTexture(chunk.Texture.get());
+    for(int l = 0; l < p_grid.getLayerCount(); l++){
+        if(layers[l].Collision){
+            continue;
+        }
+        for(int row = firstRow; row <= lastRow; row++){
+            const uint32_t* gids = p_grid.getRow(l, row);
+            for(int column = firstColumn; column <= lastColumn; column++){
+                if(gids[column] == 0){
+                    continue;
+                }
+                TileGid gid = p_template.getGid(gids[column]);
+                if(gid.Tileset == -1 || gid.Animation != -1){
+                    continue;
+                }
+                SDL_Rect src = {gid.SourcePosition.x, gid.SourcePosition.y, this->_tileSize.x, this->_tileSize.y};
+                SDL_Rect dst = {column * tileWidth - originX, row * tileHeight - originY, tileWidth, tileHeight};
+                p_graphics.blitSurface(p_template.Tilesets[gid.Tileset].Texture.get(), &src, &dst);
+            }
+        }
+    }
+    p_graphics.endRenderToTexture();
+}
+
+bool TileChunkCache::getChunkCells(int p_index, const TileGrid &p_grid, int &p_firstColumn, int &p_firstRow,
+        int &p_lastColumn, int &p_lastRow) const{
+    int tileWidth = this->_tileSize.x * globals::SPRITE_SCALE;
+    int tileHeight = this->_tileSize.y * globals::SPRITE_SCALE;
+    if(tileWidth <= 0 || tileHeight <= 0){
+        return false;
+    }
+
+    //cells overlapping the chunk; tiles sit on the grid, so nothing outside this range reaches into it
+    int originX = (p_index % this->_columns) * this->_chunkSize;
+    int originY = (p_index / this->_columns) * this->_chunkSize;
+    p_firstColumn = originX / tileWidth;
+    p_firstRow = originY / tileHeight;
+    p_lastColumn = std::min(p_grid.getWidth() - 1, (originX + this->_chunkSize - 1) / tileWidth);
+    p_lastRow = std::min(p_grid.getHeight() - 1, (originY + this->_chunkSize - 1) / tileHeight);
+    return true;
+}
+
+void TileChunkCache::drawChunkTiles(Graphics &p_graphics, const Camera &p_camera, int p_index, const TileGrid &p_grid,
+        const LevelTemplate &p_template){
+    int firstColumn, firstRow, lastColumn, lastRow;
+    if(!this->getChunkCells(p_index, p_grid, firstColumn, firstRow, lastColumn, lastRow)){
+        return;
+    }
+    if(this->_fallbackBatches.size() != p_template.Tilesets.size()){
+        this->_fallbackBatches.clear();
+        for(int i = 0; i < p_template.Tilesets.size(); i++){
+            this->_fallbackBatches.push_back(TileBatch(p_template.Tilesets[i].Texture.get()));
+        }
+    }
+
+    int tileWidth = this->_tileSize.x * globals::SPRITE_SCALE;
+    int tileHeight = this->_tileSize.y * globals::SPRITE_SCALE;
+    const std::vector<LayerData> &layers = p_template.Map->Layers;
+    for(int l = 0; l < p_grid.getLayerCount(); l++){
+        if(layers[l].Collision){
+            continue;
+        }
+        for(int row = firstRow; row <= lastRow; row++){
+            const uint32_t* gids = p_grid.getRow(l, row);
+            for(int column = firstColumn; column <= lastColumn; column++){
+                if(gids[column] == 0){
+                    continue;
+                }
+                TileGid gid = p_template.getGid(gids[column]);
+                if(gid.Tileset == -1 || gid.Animation != -1){
+                    continue;
+                }
+                this->_fallbackBatches[gid.Tileset].addTile(gid.SourcePosition, this->_tileSize,
+                    Vector2f(p_camera.toScreenX(column * tileWidth), p_camera.toScreenY(row * tileHeight)));
+            }
+        }
+
+        //one layer at a time, so later layers still cover earlier ones
+        for(int b = 0; b < this->_fallbackBatches.size(); b++){
+            this->_fallbackBatches[b].draw(p_graphics);
+            this->_fallbackBatches[b].clear();
+        }
+    }
+}
\ No newline at end of file
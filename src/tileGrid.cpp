@@ -0,0 +1,17 @@
+#include <algorithm>
+
+#include "tileGrid.h"
+
+TileGrid::TileGrid():
+    _width(0),
+    _height(0),
+    _layerCount(0)
+{}
+
+TileGrid::TileGrid(int p_width, int p_height, int p_layerCount):
+    _width(std::max(p_width, 0)),
+    _height(std::max(p_height, 0)),
+    _layerCount(std::max(p_layerCount, 0))
+{
+    this->_gids.assign((size_t)this->_width * this->_height * this->_layerCount, 0);
+}
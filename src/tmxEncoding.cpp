@@ -0,0 +1,288 @@
+#include <cstdio>
+#include <cstring>
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "tmxEncoding.h"
+
+namespace{
+    const unsigned char BASE64_INVALID = 0xFF;
+    const unsigned char BASE64_SKIP = 0xFE;
+    const unsigned char BASE64_END = 0xFD;
+
+    /**
+     * @struct Base64Table
+     * @brief Maps every character to its 6 bit value, or to one of the markers above.
+     */
+    struct Base64Table {
+        unsigned char Values[256];
+
+        Base64Table(){
+            const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+            for(int i = 0; i < 256; i++){
+                this->Values[i] = BASE64_INVALID;
+            }
+            for(int i = 0; i < 64; i++){
+                this->Values[(unsigned char)alphabet[i]] = i;
+            }
+            this->Values[(unsigned char)' '] = BASE64_SKIP;
+            this->Values[(unsigned char)'\n'] = BASE64_SKIP;
+            this->Values[(unsigned char)'\r'] = BASE64_SKIP;
+            this->Values[(unsigned char)'\t'] = BASE64_SKIP;
+            this->Values[(unsigned char)'='] = BASE64_END;
+            this->Values[0] = BASE64_END;
+        }
+    };
+
+    const Base64Table BASE64;
+}
+
+bool tmxEncoding::decodeBase64(const char* p_text, std::vector<unsigned char> &p_bytes){
+    p_bytes.clear();
+    p_bytes.reserve(std::strlen(p_text) / 4 * 3);
+    const unsigned char* c = (const unsigned char*)p_text;
+    const unsigned char* values = BASE64.Values;
+
+    //fast path: whole quads of alphabet characters, which is all of a layer but its edges
+    while(true){
+        unsigned char a = values[c[0]];
+        if(a >= 64){
+            if(a == BASE64_SKIP){
+                c++;
+                continue;
+            }
+            break;
+        }
+        unsigned char b = values[c[1]];
+        unsigned char d = b < 64 ? values[c[2]] : BASE64_INVALID;
+        unsigned char e = d < 64 ? values[c[3]] : BASE64_INVALID;
+        if(e >= 64){
+            break;
+        }
+        uint32_t quad = (a << 18) | (b << 12) | (d << 6) | e;
+        p_bytes.push_back(quad >> 16);
+        p_bytes.push_back((quad >> 8) & 0xFF);
+        p_bytes.push_back(quad & 0xFF);
+        c += 4;
+    }
+
+    //slow path for the tail: whitespace inside a quad and '=' padding
+    uint32_t buffer = 0;
+    int bits = 0;
+    for(; values[*c] != BASE64_END; c++){
+        unsigned char value = values[*c];
+        if(value == BASE64_SKIP){
+            continue;
+        }
+        if(value == BASE64_INVALID){
+            return false;
+        }
+        buffer = (buffer << 6) | value;
+        bits += 6;
+        if(bits >= 8){
+            bits -= 8;
+            p_bytes.push_back((buffer >> bits) & 0xFF);
+        }
+    }
+    return true;
+}
+
+bool tmxEncoding::decodeCsv(const char* p_text, std::vector<uint32_t> &p_gids){
+    p_gids.clear();
+    const char* c = p_text;
+    while(*c != '\0'){
+        if(*c == ',' || *c == ' ' || *c == '\n' || *c == '\r' || *c == '\t'){
+            c++;
+            continue;
+        }
+        if(*c < '0' || *c > '9'){
+            return false;
+        }
+        uint32_t gid = 0;
+        for(; *c >= '0' && *c <= '9'; c++){
+            gid = gid * 10 + (*c - '0');
+        }
+        p_gids.push_back(gid);
+    }
+    return true;
+}
+
+bool tmxEncoding::decompress(const std::string &p_compression, const std::vector<unsigned char> &p_bytes,
+        size_t p_size, std::vector<unsigned char> &p_output){
+    p_output.resize(p_size);
+
+    if(p_compression == "zlib" || p_compression == "gzip"){
+        z_stream stream = z_stream();
+        //window bits + 32 lets zlib detect a zlib or gzip header by itself
+        if(inflateInit2(&stream, 15 + 32) != Z_OK){
+            return false;
+        }
+        stream.next_in = (Bytef*)p_bytes.data();
+        stream.avail_in = p_bytes.size();
+        stream.next_out = p_output.data();
+        stream.avail_out = p_size;
+        int result = inflate(&stream, Z_FINISH);
+        size_t produced = stream.total_out;
+        inflateEnd(&stream);
+        return result == Z_STREAM_END && produced == p_size;
+    }
+
+#ifdef HAVE_ZSTD
+    if(p_compression == "zstd"){
+        size_t produced = ZSTD_decompress(p_output.data(), p_size, p_bytes.data(), p_bytes.size());
+        return !ZSTD_isError(produced) && produced == p_size;
+    }
+#endif
+
+    return false;
+}
+
+bool tmxEncoding::decodeGids(const char* p_text, const std::string &p_encoding, const std::string &p_compression,
+        size_t p_cellCount, std::vector<uint32_t> &p_gids){
+    if(p_text == NULL){
+        p_text = "";
+    }
+
+    if(p_encoding == "csv"){
+        return p_compression.empty() && tmxEncoding::decodeCsv(p_text, p_gids) && p_gids.size() == p_cellCount;
+    }
+    if(p_encoding != "base64"){
+        return false;
+    }
+
+    std::vector<unsigned char> bytes;
+    if(!tmxEncoding::decodeBase64(p_text, bytes)){
+        return false;
+    }
+    if(!p_compression.empty()){
+        std::vector<unsigned char> decompressed;
+        if(!tmxEncoding::decompress(p_compression, bytes, p_cellCount * 4, decompressed)){
+            return false;
+        }
+        bytes.swap(decompressed);
+    }
+    if(bytes.size() != p_cellCount * 4){
+        return false;
+    }
+
+    p_gids.resize(p_cellCount);
+    for(size_t i = 0; i < p_cellCount; i++){
+        const unsigned char* gid = &bytes[i * 4];
+        p_gids[i] = (uint32_t)gid[0] | ((uint32_t)gid[1] << 8) | ((uint32_t)gid[2] << 16) | ((uint32_t)gid[3] << 24);
+    }
+    return true;
+}
+
+bool tmxEncoding::isCompressionSupported(const std::string &p_compression){
+#ifdef HAVE_ZSTD
+    if(p_compression == "zstd"){
+        return true;
+    }
+#endif
+    return p_compression == "zlib" || p_compression == "gzip";
+}
+
+void tmxEncoding::encodeBase64(const std::vector<unsigned char> &p_bytes, std::string &p_text){
+    const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    p_text.clear();
+    p_text.reserve((p_bytes.size() + 2) / 3 * 4);
+    for(size_t i = 0; i < p_bytes.size(); i += 3){
+        size_t remaining = p_bytes.size() - i;
+        uint32_t quad = (uint32_t)p_bytes[i] << 16;
+        if(remaining > 1){
+            quad |= (uint32_t)p_bytes[i + 1] << 8;
+        }
+        if(remaining > 2){
+            quad |= p_bytes[i + 2];
+        }
+        p_text += alphabet[(quad >> 18) & 0x3F];
+        p_text += alphabet[(quad >> 12) & 0x3F];
+        p_text += remaining > 1 ? alphabet[(quad >> 6) & 0x3F] : '=';
+        p_text += remaining > 2 ? alphabet[quad & 0x3F] : '=';
+    }
+}
+
+void tmxEncoding::encodeCsv(const std::vector<uint32_t> &p_gids, int p_width, std::string &p_text){
+    p_text.clear();
+    p_text += '\n';
+    char number[16];
+    for(size_t i = 0; i < p_gids.size(); i++){
+        int length = std::snprintf(number, sizeof(number), "%u", (unsigned)p_gids[i]);
+        p_text.append(number, length);
+        if(i + 1 < p_gids.size()){
+            p_text += ',';
+        }
+        if(p_width > 0 && (i + 1) % p_width == 0){
+            p_text += '\n';
+        }
+    }
+}
+
+bool tmxEncoding::compress(const std::string &p_compression, const std::vector<unsigned char> &p_bytes,
+        std::vector<unsigned char> &p_output){
+    if(p_compression == "zlib" || p_compression == "gzip"){
+        z_stream stream = z_stream();
+        //window bits + 16 writes a gzip header instead of a zlib one
+        int windowBits = p_compression == "gzip" ? 15 + 16 : 15;
+        if(deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK){
+            return false;
+        }
+        p_output.resize(deflateBound(&stream, p_bytes.size()));
+        stream.next_in = (Bytef*)p_bytes.data();
+        stream.avail_in = p_bytes.size();
+        stream.next_out = p_output.data();
+        stream.avail_out = p_output.size();
+        int result = deflate(&stream, Z_FINISH);
+        p_output.resize(stream.total_out);
+        deflateEnd(&stream);
+        return result == Z_STREAM_END;
+    }
+
+#ifdef HAVE_ZSTD
+    if(p_compression == "zstd"){
+        p_output.resize(ZSTD_compressBound(p_bytes.size()));
+        size_t produced = ZSTD_compress(p_output.data(), p_output.size(), p_bytes.data(), p_bytes.size(),
+            ZSTD_CLEVEL_DEFAULT);
+        if(ZSTD_isError(produced)){
+            return false;
+        }
+        p_output.resize(produced);
+        return true;
+    }
+#endif
+
+    return false;
+}
+
+bool tmxEncoding::encodeGids(const std::vector<uint32_t> &p_gids, int p_width, const std::string &p_encoding,
+        const std::string &p_compression, std::string &p_text){
+    if(p_encoding == "csv"){
+        if(!p_compression.empty()){
+            return false;
+        }
+        tmxEncoding::encodeCsv(p_gids, p_width, p_text);
+        return true;
+    }
+    if(p_encoding != "base64"){
+        return false;
+    }
+
+    std::vector<unsigned char> bytes(p_gids.size() * 4);
+    for(size_t i = 0; i < p_gids.size(); i++){
+        bytes[i * 4] = p_gids[i] & 0xFF;
+        bytes[i * 4 + 1] = (p_gids[i] >> 8) & 0xFF;
+        bytes[i * 4 + 2] = (p_gids[i] >> 16) & 0xFF;
+        bytes[i * 4 + 3] = (p_gids[i] >> 24) & 0xFF;
+    }
+    if(!p_compression.empty()){
+        std::vector<unsigned char> compressed;
+        if(!tmxEncoding::compress(p_compression, bytes, compressed)){
+            return false;
+        }
+        bytes.swap(compressed);
+    }
+    tmxEncoding::encodeBase64(bytes, p_text);
+    return true;
+}
@@ -0,0 +1,44 @@
+/**
+ * @file check.h
+ * @brief Minimal assertions shared by the tests in tests/.
+ *
+ * Each test is a plain executable: CHECK() reports every failed condition with its location and
+ * keeps going, and main() returns check::result() so ctest sees a non-zero status on any failure.
+ */
+
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <cstdio>
+
+namespace check {
+    inline int &failures(){
+        static int count = 0;
+        return count;
+    }
+
+    inline void report(bool p_passed, const char* p_condition, const char* p_file, int p_line){
+        if(!p_passed){
+            printf("\nError: %s:%d: CHECK(%s) failed\n", p_file, p_line, p_condition);
+            failures()++;
+        }
+    }
+
+    /**
+     * @brief Prints the outcome and gets the status main() should return.
+     *
+     * @return int: 0 if every check passed, 1 otherwise.
+     */
+    inline int result(){
+        if(failures() > 0){
+            printf("%d check(s) failed\n", failures());
+            return 1;
+        }
+        printf("All checks passed\n");
+        return 0;
+    }
+}
+
+#define CHECK(condition) check::report((condition), #condition, __FILE__, __LINE__)
+
+#endif /* CHECK_H */
@@ -0,0 +1,56 @@
+/**
+ * @file collisionMask.cpp
+ * @brief Checks CollisionMask bits against a plain array, across 64 bit word boundaries.
+ */
+
+#include <vector>
+
+#include "check.h"
+#include "collisionMask.h"
+
+int main(){
+    //nothing is solid in a default mask
+    CollisionMask empty;
+    CHECK(empty.getWidth() == 0 && empty.getHeight() == 0);
+    CHECK(!empty.isSolid(0, 0));
+
+    //a width just past two words, so rows don't start on a word boundary of the previous row
+    const int width = 130;
+    const int height = 7;
+    CollisionMask mask(width, height);
+    CHECK(mask.getWidth() == width && mask.getHeight() == height);
+
+    std::vector<bool> expected(width * height, false);
+    for(int y = 0; y < height; y++){
+        for(int x = 0; x < width; x++){
+            bool solid = (x * 7 + y * 3) % 5 == 0 || x == 63 || x == 64 || x == width - 1;
+            mask.setSolid(x, y, solid);
+            expected[y * width + x] = solid;
+        }
+    }
+
+    //clearing bits must not touch their neighbours
+    for(int y = 0; y < height; y++){
+        mask.setSolid(64, y, false);
+        expected[y * width + 64] = false;
+    }
+
+    for(int y = 0; y < height; y++){
+        for(int x = 0; x < width; x++){
+            CHECK(mask.isSolid(x, y) == expected[y * width + x]);
+        }
+    }
+
+    //cells outside the mask are empty, and setting them is ignored
+    mask.setSolid(-1, 0, true);
+    mask.setSolid(width, 0, true);
+    mask.setSolid(0, height, true);
+    CHECK(!mask.isSolid(-1, 0));
+    CHECK(!mask.isSolid(width, 0));
+    CHECK(!mask.isSolid(0, -1));
+    CHECK(!mask.isSolid(0, height));
+    CHECK(mask.isSolid(0, 0) == expected[0]);
+    CHECK(mask.isSolid(width - 1, height - 1));
+
+    return check::result();
+}
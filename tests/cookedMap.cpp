@@ -0,0 +1,189 @@
+/**
+ * @file cookedMap.cpp
+ * @brief Round trips maps through MapData::saveCooked/loadCooked, and checks broken files are rejected.
+ *
+ * Run from the build directory so the maps are read from ../res; the cooked files are written there too.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "check.h"
+#include "mapData.h"
+#include "tmxEncoding.h"
+
+namespace{
+    const std::string COOKED_PATH = "test_cookedMap.cmap";
+    const std::string BROKEN_PATH = "test_cookedMap_broken.cmap";
+    const size_t VERSION_OFFSET = 4; // right after the magic
+
+    bool equals(const Vector2f &p_a, const Vector2f &p_b){
+        return p_a.x == p_b.x && p_a.y == p_b.y;
+    }
+
+    bool equals(const Rectangle &p_a, const Rectangle &p_b){
+        return p_a.getLeft() == p_b.getLeft() && p_a.getTop() == p_b.getTop() &&
+               p_a.getWidth() == p_b.getWidth() && p_a.getHeight() == p_b.getHeight();
+    }
+
+    void checkEqual(const MapData &p_a, const MapData &p_b){
+        CHECK(equals(p_a.Size, p_b.Size));
+        CHECK(equals(p_a.TileSize, p_b.TileSize));
+        CHECK(equals(p_a.SpawnPoint, p_b.SpawnPoint));
+        CHECK(p_a.Infinite == p_b.Infinite);
+        CHECK(equals(p_a.Origin, p_b.Origin));
+
+        CHECK(p_a.Tilesets.size() == p_b.Tilesets.size());
+        for(int i = 0; i < p_a.Tilesets.size() && i < p_b.Tilesets.size(); i++){
+            CHECK(p_a.Tilesets[i].ImagePath == p_b.Tilesets[i].ImagePath);
+            CHECK(p_a.Tilesets[i].FirstGid == p_b.Tilesets[i].FirstGid);
+            CHECK(p_a.Tilesets[i].ImageWidth == p_b.Tilesets[i].ImageWidth);
+            CHECK(p_a.Tilesets[i].ImageHeight == p_b.Tilesets[i].ImageHeight);
+        }
+
+        CHECK(p_a.Animations.size() == p_b.Animations.size());
+        for(int i = 0; i < p_a.Animations.size() && i < p_b.Animations.size(); i++){
+            CHECK(p_a.Animations[i].StartTileId == p_b.Animations[i].StartTileId);
+            CHECK(p_a.Animations[i].TileIds == p_b.Animations[i].TileIds);
+            CHECK(p_a.Animations[i].Duration == p_b.Animations[i].Duration);
+        }
+        CHECK(p_a.SolidGids == p_b.SolidGids);
+        CHECK(p_a.SourcePositions.size() == p_b.SourcePositions.size());
+
+        CHECK(p_a.Layers.size() == p_b.Layers.size());
+        for(int l = 0; l < p_a.Layers.size() && l < p_b.Layers.size(); l++){
+            const LayerData &a = p_a.Layers[l];
+            const LayerData &b = p_b.Layers[l];
+            CHECK(a.Collision == b.Collision);
+            CHECK(a.Gids == b.Gids);
+            CHECK(a.Chunks.size() == b.Chunks.size());
+            for(int c = 0; c < a.Chunks.size() && c < b.Chunks.size(); c++){
+                CHECK(a.Chunks[c].X == b.Chunks[c].X && a.Chunks[c].Y == b.Chunks[c].Y);
+                CHECK(a.Chunks[c].Width == b.Chunks[c].Width && a.Chunks[c].Height == b.Chunks[c].Height);
+                CHECK(a.Chunks[c].Encoding == b.Chunks[c].Encoding);
+                CHECK(a.Chunks[c].Compression == b.Chunks[c].Compression);
+                CHECK(a.Chunks[c].Payload == b.Chunks[c].Payload);
+                CHECK(a.Chunks[c].Gids == b.Chunks[c].Gids);
+            }
+        }
+
+        CHECK(p_a.CollisionRects.size() == p_b.CollisionRects.size());
+        for(int i = 0; i < p_a.CollisionRects.size() && i < p_b.CollisionRects.size(); i++){
+            CHECK(equals(p_a.CollisionRects[i], p_b.CollisionRects[i]));
+        }
+        CHECK(p_a.Slopes.size() == p_b.Slopes.size());
+        for(int i = 0; i < p_a.Slopes.size() && i < p_b.Slopes.size(); i++){
+            CHECK(equals(p_a.Slopes[i].getP1(), p_b.Slopes[i].getP1()));
+            CHECK(equals(p_a.Slopes[i].getP2(), p_b.Slopes[i].getP2()));
+        }
+        CHECK(p_a.Doors.size() == p_b.Doors.size());
+        for(int i = 0; i < p_a.Doors.size() && i < p_b.Doors.size(); i++){
+            CHECK(equals(p_a.Doors[i].Rect, p_b.Doors[i].Rect));
+            CHECK(p_a.Doors[i].Destination == p_b.Doors[i].Destination);
+        }
+        CHECK(p_a.Enemies.size() == p_b.Enemies.size());
+        for(int i = 0; i < p_a.Enemies.size() && i < p_b.Enemies.size(); i++){
+            CHECK(p_a.Enemies[i].Name == p_b.Enemies[i].Name);
+            CHECK(equals(p_a.Enemies[i].Position, p_b.Enemies[i].Position));
+        }
+    }
+
+    void checkRoundTrip(const MapData &p_map){
+        CHECK(p_map.saveCooked(COOKED_PATH));
+        MapData loaded;
+        CHECK(MapData::loadCooked(COOKED_PATH, loaded));
+        checkEqual(p_map, loaded);
+    }
+
+    /**
+     * @brief An infinite map with one chunk in each of the stored forms, decoded and encoded.
+     */
+    MapData makeInfiniteMap(){
+        MapData map;
+        map.Size = Vector2f(32, 16);
+        map.TileSize = Vector2f(16, 16);
+        map.Infinite = true;
+        map.Origin = Vector2f(-16, 0);
+        map.SolidGids = {3, 7};
+
+        LayerData layer;
+        layer.Collision = false;
+        for(int c = 0; c < 2; c++){
+            ChunkData chunk;
+            chunk.X = c * 16;
+            chunk.Y = 0;
+            chunk.Width = 16;
+            chunk.Height = 16;
+            std::vector<uint32_t> gids(16 * 16);
+            for(int i = 0; i < gids.size(); i++){
+                gids[i] = (i * 7 + c) % 11;
+            }
+            if(c == 0){
+                chunk.Gids = gids;
+            } else {
+                chunk.Encoding = "base64";
+                chunk.Compression = "zlib";
+                CHECK(tmxEncoding::encodeGids(gids, 16, chunk.Encoding, chunk.Compression, chunk.Payload));
+            }
+            layer.Chunks.push_back(chunk);
+        }
+        map.Layers.push_back(layer);
+        return map;
+    }
+
+    std::vector<char> readFile(const std::string &p_filePath){
+        std::ifstream in(p_filePath.c_str(), std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    void writeFile(const std::string &p_filePath, const std::vector<char> &p_bytes){
+        std::ofstream out(p_filePath.c_str(), std::ios::binary | std::ios::trunc);
+        out.write(p_bytes.data(), p_bytes.size());
+    }
+
+    bool loadsBroken(const std::vector<char> &p_bytes){
+        writeFile(BROKEN_PATH, p_bytes);
+        MapData map;
+        return MapData::loadCooked(BROKEN_PATH, map);
+    }
+}
+
+int main(){
+    const char* MAP_NAMES[] = {"Map 1", "Map 2"};
+    for(int m = 0; m < 2; m++){
+        MapData map;
+        CHECK(MapData::loadTmx(std::string("../res/maps/") + MAP_NAMES[m] + ".tmx", map));
+        checkRoundTrip(map);
+    }
+    checkRoundTrip(makeInfiniteMap());
+
+    //every truncation of a valid file is rejected, not read past its end
+    std::vector<char> bytes = readFile(COOKED_PATH);
+    CHECK(bytes.size() > VERSION_OFFSET + 4);
+    CHECK(!loadsBroken(std::vector<char>()));
+    for(size_t size = 1; size < bytes.size(); size += 1 + size / 8){
+        CHECK(!loadsBroken(std::vector<char>(bytes.begin(), bytes.begin() + size)));
+    }
+    CHECK(!loadsBroken(std::vector<char>(bytes.begin(), bytes.end() - 1)));
+
+    //so are other versions and other magics
+    std::vector<char> versioned = bytes;
+    versioned[VERSION_OFFSET] = (char)(MapData::COOKED_VERSION + 1);
+    CHECK(!loadsBroken(versioned));
+    std::vector<char> magic = bytes;
+    magic[0] = 'X';
+    CHECK(!loadsBroken(magic));
+
+    //the untouched bytes still load, so the rejections above come from the damage
+    CHECK(loadsBroken(bytes));
+
+    MapData missing;
+    CHECK(!MapData::loadCooked("test_cookedMap_missing.cmap", missing));
+
+    std::remove(COOKED_PATH.c_str());
+    std::remove(BROKEN_PATH.c_str());
+    return check::result();
+}
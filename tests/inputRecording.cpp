@@ -0,0 +1,138 @@
+/**
+ * @file inputRecording.cpp
+ * @brief Records scripted keyboard input, saves and loads it, and checks the replay matches it tick for tick.
+ *
+ * The recording files are written to the working directory.
+ */
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "check.h"
+#include "input.h"
+#include "inputRecording.h"
+
+namespace{
+    const std::string RECORDING_PATH = "test_inputRecording.rec";
+    const std::string BROKEN_PATH = "test_inputRecording_broken.rec";
+    const int TICK_COUNT = 2000;
+    const int TICK_RATE = 120;
+
+    //the game's keys, plus the last scancode the 9 bits of a change can store
+    const SDL_Scancode KEYS[] = {SDL_SCANCODE_LEFT, SDL_SCANCODE_RIGHT, SDL_SCANCODE_UP, SDL_SCANCODE_DOWN,
+        SDL_SCANCODE_SPACE, SDL_SCANCODE_ESCAPE, SDL_SCANCODE_F9, (SDL_Scancode)(SDL_NUM_SCANCODES - 1)};
+    const int KEY_COUNT = sizeof(KEYS) / sizeof(KEYS[0]);
+
+    uint32_t state = 7;
+
+    int random(int p_max){
+        state = state * 1664525u + 1013904223u;
+        return (state >> 8) % p_max;
+    }
+
+    SDL_Event makeKeyEvent(Uint32 p_type, SDL_Scancode p_key){
+        SDL_Event event;
+        event.type = p_type;
+        event.key.keysym.scancode = p_key;
+        event.key.repeat = 0;
+        return event;
+    }
+
+    /**
+     * @brief Packs the state of every tested key, so a tick compares in one go.
+     */
+    std::vector<int> getKeyStates(const Input &p_input){
+        std::vector<int> states;
+        for(int k = 0; k < KEY_COUNT; k++){
+            states.push_back((p_input.wasKeyPressed(KEYS[k]) ? 1 : 0) | (p_input.wasKeyReleased(KEYS[k]) ? 2 : 0) |
+                (p_input.isKeyHeld(KEYS[k]) ? 4 : 0));
+        }
+        return states;
+    }
+
+    std::vector<char> readFile(const std::string &p_filePath){
+        std::ifstream in(p_filePath.c_str(), std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    bool loadsBroken(const std::vector<char> &p_bytes){
+        std::ofstream out(BROKEN_PATH.c_str(), std::ios::binary | std::ios::trunc);
+        out.write(p_bytes.data(), p_bytes.size());
+        out.close();
+        InputRecording recording;
+        return recording.load(BROKEN_PATH);
+    }
+}
+
+int main(){
+    //live input the way the game feeds it: edges cleared each tick, then that tick's events
+    Input live;
+    InputRecording recording;
+    recording.setTickRate(TICK_RATE);
+    std::vector<std::vector<int>> expected;
+    for(int tick = 0; tick < TICK_COUNT; tick++){
+        live.beginNewFrame();
+        //bursts of activity between quiet stretches, some longer than a one byte varint
+        bool quiet = (tick / 300) % 2 == 1;
+        int events = quiet ? 0 : random(4);
+        for(int e = 0; e < events; e++){
+            SDL_Scancode key = KEYS[random(KEY_COUNT)];
+            live.keyDownEvent(makeKeyEvent(SDL_KEYDOWN, key));
+            if(random(2) == 0){
+                //pressed and released within the same tick
+                live.keyUpEvent(makeKeyEvent(SDL_KEYUP, key));
+            }
+        }
+        if(!quiet && random(3) == 0){
+            live.keyUpEvent(makeKeyEvent(SDL_KEYUP, KEYS[random(KEY_COUNT)]));
+        }
+        recording.record(live);
+        expected.push_back(getKeyStates(live));
+    }
+    CHECK(recording.getTickCount() == TICK_COUNT);
+    CHECK(recording.save(RECORDING_PATH));
+
+    InputRecording loaded;
+    CHECK(loaded.load(RECORDING_PATH));
+    CHECK(loaded.getTickRate() == TICK_RATE);
+    CHECK(loaded.getTickCount() == TICK_COUNT);
+
+    //the replay only touches the keys it changed, so a fresh Input ends up in every recorded state
+    Input replayed;
+    int mismatches = 0;
+    for(int tick = 0; tick < TICK_COUNT; tick++){
+        CHECK(!loaded.isFinished());
+        CHECK(loaded.replay(replayed));
+        mismatches += getKeyStates(replayed) != expected[tick] ? 1 : 0;
+    }
+    CHECK(mismatches == 0);
+    CHECK(loaded.isFinished());
+    CHECK(!loaded.replay(replayed));
+
+    //an empty recording round trips too
+    InputRecording empty;
+    CHECK(empty.save(RECORDING_PATH));
+    CHECK(loaded.load(RECORDING_PATH));
+    CHECK(loaded.getTickCount() == 0);
+    CHECK(loaded.isFinished());
+
+    //broken files are rejected
+    CHECK(recording.save(RECORDING_PATH));
+    std::vector<char> bytes = readFile(RECORDING_PATH);
+    CHECK(loadsBroken(bytes));
+    CHECK(!loadsBroken(std::vector<char>(bytes.begin(), bytes.begin() + bytes.size() / 2)));
+    std::vector<char> magic = bytes;
+    magic[0] = 'X';
+    CHECK(!loadsBroken(magic));
+    InputRecording missing;
+    CHECK(!missing.load("test_inputRecording_missing.rec"));
+
+    std::remove(RECORDING_PATH.c_str());
+    std::remove(BROKEN_PATH.c_str());
+    return check::result();
+}
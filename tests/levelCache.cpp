@@ -0,0 +1,85 @@
+/**
+ * @file levelCache.cpp
+ * @brief Checks LevelCache's least recently used eviction and its hit and miss counts.
+ *
+ * Runs on SDL's dummy video driver, from the build directory so the maps are read from ../res.
+ */
+
+#include <SDL2/SDL.h>
+#include <memory>
+#include <string>
+
+#include "check.h"
+#include "graphics.h"
+#include "levelCache.h"
+#include "mapData.h"
+
+namespace{
+    const size_t TEMPLATE_BYTES = 1000; // every fake template claims this much
+
+    std::shared_ptr<const LevelTemplate> makeTemplate(const std::string &p_name){
+        std::shared_ptr<LevelTemplate> levelTemplate = LevelCache::makeTemplate(p_name, std::make_shared<MapData>(),
+            std::vector<Tileset>());
+        levelTemplate->Bytes = TEMPLATE_BYTES;
+        return levelTemplate;
+    }
+}
+
+int main(){
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER);
+    {
+        Graphics graphics(false, true);
+
+        //room for two templates and a half
+        LevelCache cache(TEMPLATE_BYTES * 5 / 2);
+        cache.insert(makeTemplate("a"));
+        cache.insert(makeTemplate("b"));
+        CHECK(cache.getCount() == 2);
+        CHECK(cache.getBytes() == 2 * TEMPLATE_BYTES);
+
+        //using "a" makes "b" the least recently used, so it goes when "c" comes in
+        std::shared_ptr<const LevelTemplate> a = cache.getTemplate("a", graphics);
+        CHECK(a->Name == "a");
+        cache.insert(makeTemplate("c"));
+        CHECK(cache.contains("a"));
+        CHECK(!cache.contains("b"));
+        CHECK(cache.contains("c"));
+        CHECK(cache.getBytes() == 2 * TEMPLATE_BYTES);
+        CHECK(cache.getHits() == 1);
+        CHECK(cache.getMisses() == 0);
+
+        //inserting a cached map again neither duplicates it nor counts as a use
+        cache.insert(makeTemplate("a"));
+        CHECK(cache.getCount() == 2);
+        CHECK(cache.getTemplate("a", graphics) == a);
+        CHECK(cache.getHits() == 2);
+
+        //a real map is a miss, then a hit; it's far bigger than the cap, so it alone stays
+        std::shared_ptr<const LevelTemplate> map = cache.getTemplate("Map 1", graphics);
+        CHECK(map->Map->Size.x > 0);
+        CHECK(cache.getMisses() == 1);
+        CHECK(cache.getTemplate("Map 1", graphics) == map);
+        CHECK(cache.getHits() == 3);
+        CHECK(cache.getCount() == 1);
+        CHECK(cache.contains("Map 1"));
+        CHECK(cache.getBytes() == map->Bytes);
+
+        //the evicted templates live on as long as someone holds them
+        CHECK(a->Name == "a");
+
+        //failed loads are misses and aren't cached, so they are tried again
+        std::shared_ptr<const LevelTemplate> missing = cache.getTemplate("No such map", graphics);
+        CHECK(missing->Map->Layers.empty());
+        CHECK(!cache.contains("No such map"));
+        cache.getTemplate("No such map", graphics);
+        CHECK(cache.getMisses() == 3);
+        CHECK(cache.getCount() == 1);
+
+        cache.clear();
+        CHECK(cache.getCount() == 0);
+        CHECK(cache.getBytes() == 0);
+    }
+    SDL_Quit();
+    return check::result();
+}
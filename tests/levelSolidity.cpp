@@ -0,0 +1,139 @@
+/**
+ * @file levelSolidity.cpp
+ * @brief Checks that a level's solid cells are the same whether they come from loading, streaming or setTile.
+ *
+ * Runs on SDL's dummy video driver, from the build directory so the tileset is read from ../res.
+ */
+
+#include <SDL2/SDL.h>
+#include <memory>
+#include <vector>
+
+#include "check.h"
+#include "graphics.h"
+#include "level.h"
+#include "levelCache.h"
+#include "mapData.h"
+
+namespace{
+    const int WIDTH = 8;
+    const int HEIGHT = 6;
+    const uint32_t SOLID_GID = 2;
+    const uint32_t PLAIN_GID = 3;
+    const uint32_t ANIMATED_GID = 5; // first tile of the map's only animation, solid too
+
+    /**
+     * @brief Makes a map with a solid static tile at (1, 1) and a solid animated one at (4, 3) on its first layer.
+     *
+     * @param p_infinite True to store the layers as a single chunk, like an infinite map.
+     */
+    std::shared_ptr<MapData> makeMap(bool p_infinite){
+        std::shared_ptr<MapData> map = std::make_shared<MapData>();
+        map->Size = Vector2f(WIDTH, HEIGHT);
+        map->TileSize = Vector2f(16, 16);
+        map->Infinite = p_infinite;
+
+        TilesetData tileset;
+        tileset.ImagePath = "../res/tilesets/PrtCave.png";
+        tileset.FirstGid = 1;
+        tileset.ImageWidth = 256;
+        tileset.ImageHeight = 80;
+        map->Tilesets.push_back(tileset);
+
+        AnimatedTileInfo animation;
+        animation.TilesetsFirstGid = 1;
+        animation.StartTileId = ANIMATED_GID;
+        animation.TileIds = {5, 6, 7};
+        animation.Duration = 100;
+        map->Animations.push_back(animation);
+        map->SolidGids = {SOLID_GID, ANIMATED_GID};
+
+        for(int l = 0; l < 2; l++){
+            std::vector<uint32_t> gids(WIDTH * HEIGHT, 0);
+            if(l == 0){
+                gids[1 * WIDTH + 1] = SOLID_GID;
+                gids[3 * WIDTH + 4] = ANIMATED_GID;
+            }
+            LayerData layer;
+            layer.Collision = false;
+            if(p_infinite){
+                ChunkData chunk;
+                chunk.X = 0;
+                chunk.Y = 0;
+                chunk.Width = WIDTH;
+                chunk.Height = HEIGHT;
+                chunk.Gids = gids;
+                layer.Chunks.push_back(chunk);
+            } else {
+                layer.Gids = gids;
+            }
+            map->Layers.push_back(layer);
+        }
+        map->computeSourcePositions();
+        return map;
+    }
+
+    std::shared_ptr<const LevelTemplate> makeTemplate(const std::shared_ptr<MapData> &p_map, Graphics &p_graphics){
+        std::vector<Tileset> tilesets;
+        tilesets.push_back(Tileset(p_graphics.loadTexture(p_map->Tilesets[0].ImagePath), p_map->Tilesets[0].FirstGid));
+        return LevelCache::makeTemplate("solidity", p_map, tilesets);
+    }
+
+    bool isSolidCell(Level &p_level, int p_x, int p_y){
+        int tileSize = 16 * globals::SPRITE_SCALE;
+        std::vector<Rectangle> hits;
+        p_level.checkTileCollisions(Rectangle(p_x * tileSize + 2, p_y * tileSize + 2, 4, 4), hits);
+        return !hits.empty();
+    }
+
+    std::vector<bool> getSolidCells(Level &p_level){
+        std::vector<bool> cells;
+        for(int y = 0; y < HEIGHT; y++){
+            for(int x = 0; x < WIDTH; x++){
+                cells.push_back(isSolidCell(p_level, x, y));
+            }
+        }
+        return cells;
+    }
+}
+
+int main(){
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER);
+    {
+        Graphics graphics(false, true);
+        Level level(makeTemplate(makeMap(false), graphics), graphics);
+
+        //solid tiles count whether they animate or not
+        std::vector<bool> loaded = getSolidCells(level);
+        CHECK(loaded[1 * WIDTH + 1]);
+        CHECK(loaded[3 * WIDTH + 4]);
+        CHECK(!loaded[3 * WIDTH + 3]);
+
+        //editing around the animated tile, and over it on another layer, must not change the mask
+        level.setTile(0, 3, 3, PLAIN_GID);
+        level.setTile(0, 3, 3, 0);
+        level.setTile(1, 4, 3, PLAIN_GID);
+        level.setTile(1, 4, 3, 0);
+        CHECK(getSolidCells(level) == loaded);
+
+        //replacing the tiles follows the same rule as loading them
+        level.setTile(0, 4, 3, PLAIN_GID);
+        CHECK(!isSolidCell(level, 4, 3));
+        level.setTile(0, 4, 3, ANIMATED_GID);
+        CHECK(isSolidCell(level, 4, 3));
+        level.setTile(0, 6, 5, SOLID_GID);
+        CHECK(isSolidCell(level, 6, 5));
+        level.setTile(0, 6, 5, 0);
+        CHECK(getSolidCells(level) == loaded);
+
+        //an infinite map loaded whole or streamed marks the same cells
+        std::shared_ptr<const LevelTemplate> infinite = makeTemplate(makeMap(true), graphics);
+        Level whole(infinite, graphics);
+        Level streamed(infinite, graphics, 1);
+        CHECK(getSolidCells(whole) == loaded);
+        CHECK(getSolidCells(streamed) == loaded);
+    }
+    SDL_Quit();
+    return check::result();
+}
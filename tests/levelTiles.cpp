@@ -0,0 +1,117 @@
+/**
+ * @file levelTiles.cpp
+ * @brief Checks that Level::getTile and Level::setTile see, add and remove animated tiles.
+ *
+ * Runs on SDL's dummy video driver, from the build directory so the tileset is read from ../res.
+ */
+
+#include <SDL2/SDL.h>
+#include <memory>
+#include <vector>
+
+#include "camera.h"
+#include "check.h"
+#include "graphics.h"
+#include "level.h"
+#include "levelCache.h"
+#include "mapData.h"
+
+namespace{
+    const int WIDTH = 8;
+    const int HEIGHT = 6;
+    const uint32_t STATIC_GID = 2;
+    const uint32_t ANIMATED_GID = 5; // first tile of the map's only animation
+
+    std::shared_ptr<const LevelTemplate> makeTemplate(Graphics &p_graphics){
+        std::shared_ptr<MapData> map = std::make_shared<MapData>();
+        map->Size = Vector2f(WIDTH, HEIGHT);
+        map->TileSize = Vector2f(16, 16);
+
+        TilesetData tileset;
+        tileset.ImagePath = "../res/tilesets/PrtCave.png";
+        tileset.FirstGid = 1;
+        tileset.ImageWidth = 256;
+        tileset.ImageHeight = 80;
+        map->Tilesets.push_back(tileset);
+
+        AnimatedTileInfo animation;
+        animation.TilesetsFirstGid = 1;
+        animation.StartTileId = ANIMATED_GID;
+        animation.TileIds = {5, 6, 7};
+        animation.Duration = 100;
+        map->Animations.push_back(animation);
+
+        //two layers with an animated tile each, so edits in the first one move the second one's tiles
+        for(int l = 0; l < 2; l++){
+            LayerData layer;
+            layer.Gids.assign(WIDTH * HEIGHT, 0);
+            layer.Collision = false;
+            map->Layers.push_back(layer);
+        }
+        map->Layers[0].Gids[1 * WIDTH + 1] = STATIC_GID;
+        map->Layers[0].Gids[3 * WIDTH + 2] = ANIMATED_GID;
+        map->Layers[1].Gids[4 * WIDTH + 6] = ANIMATED_GID;
+        map->computeSourcePositions();
+
+        std::vector<Tileset> tilesets;
+        tilesets.push_back(Tileset(p_graphics.loadTexture(tileset.ImagePath), tileset.FirstGid));
+        return LevelCache::makeTemplate("tiles", map, tilesets);
+    }
+}
+
+int main(){
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER);
+    {
+        Graphics graphics(false, true);
+        Level level(makeTemplate(graphics), graphics);
+
+        //the map's animated tiles read back like static ones
+        CHECK(level.getTile(0, 1, 1) == STATIC_GID);
+        CHECK(level.getTile(0, 2, 3) == ANIMATED_GID);
+        CHECK(level.getTile(1, 6, 4) == ANIMATED_GID);
+        CHECK(level.getAnimatedTileCount() == 2);
+
+        //clearing an animated cell drops its animation
+        level.setTile(0, 2, 3, 0);
+        CHECK(level.getTile(0, 2, 3) == 0);
+        CHECK(level.getAnimatedTileCount() == 1);
+
+        //animated gids set in the same row, out of order, and in an earlier layer
+        level.setTile(0, 5, 4, ANIMATED_GID);
+        level.setTile(0, 1, 4, ANIMATED_GID);
+        level.setTile(1, 0, 4, ANIMATED_GID);
+        CHECK(level.getTile(0, 5, 4) == ANIMATED_GID);
+        CHECK(level.getAnimatedTileCount() == 4);
+
+        //replacing an animated tile, static or animated, keeps one animation per animated cell
+        level.setTile(0, 5, 4, STATIC_GID);
+        level.setTile(0, 1, 4, ANIMATED_GID);
+        CHECK(level.getTile(0, 5, 4) == STATIC_GID);
+        CHECK(level.getAnimatedTileCount() == 3);
+
+        //the second layer's tiles were shifted along, so they can still be found and removed
+        level.setTile(1, 6, 4, 0);
+        level.setTile(1, 0, 4, 0);
+        CHECK(level.getAnimatedTileCount() == 1);
+        level.setTile(0, 1, 4, 0);
+        CHECK(level.getAnimatedTileCount() == 0);
+
+        //cells outside the level are ignored
+        level.setTile(0, WIDTH, 0, ANIMATED_GID);
+        level.setTile(2, 0, 0, ANIMATED_GID);
+        CHECK(level.getTile(0, WIDTH, 0) == 0);
+        CHECK(level.getAnimatedTileCount() == 0);
+
+        //drawing every mode after the edits must not trip over the moved ranges
+        Camera camera;
+        for(int mode = tiledraw::PER_TILE; mode <= tiledraw::CACHED; mode++){
+            level.setTile(0, 3, 2, ANIMATED_GID);
+            level.setTileDrawMode((tiledraw::Mode)mode);
+            level.draw(graphics, camera, 1.0f);
+        }
+        CHECK(level.getAnimatedTileCount() == 1);
+    }
+    SDL_Quit();
+    return check::result();
+}
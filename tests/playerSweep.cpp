@@ -0,0 +1,69 @@
+/**
+ * @file playerSweep.cpp
+ * @brief Checks the player stops at thin walls and floors instead of tunnelling through them on long ticks.
+ *
+ * Runs on SDL's dummy video driver, from the build directory so the player's sprite is read from ../res.
+ */
+
+#include <SDL2/SDL.h>
+#include <memory>
+
+#include "check.h"
+#include "graphics.h"
+#include "level.h"
+#include "levelCache.h"
+#include "mapData.h"
+#include "player.h"
+
+namespace{
+    const float LONG_TICK = 2000.0f; // ms, walking 400 px and falling thousands in one update
+    const Rectangle RIGHT_WALL = Rectangle(400, 0, 2, 960);
+    const Rectangle LEFT_WALL = Rectangle(50, 0, 2, 960);
+    const Rectangle FLOOR = Rectangle(0, 600, 1280, 2);
+    const Rectangle HIGH_LEDGE = Rectangle(200, 0, 2, 50); // crossed sideways far below, must not stop the player
+
+    std::shared_ptr<const LevelTemplate> makeTemplate(){
+        std::shared_ptr<MapData> map = std::make_shared<MapData>();
+        map->Size = Vector2f(40, 30);
+        map->TileSize = Vector2f(16, 16);
+        map->CollisionRects = {RIGHT_WALL, LEFT_WALL, FLOOR, HIGH_LEDGE};
+        return LevelCache::makeTemplate("sweep", map, std::vector<Tileset>());
+    }
+}
+
+int main(){
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER);
+    {
+        Graphics graphics(false, true);
+        Level level(makeTemplate(), graphics);
+        Player player(graphics, Vector2f(100, 100));
+        int width = player.getBoundingBox().getWidth();
+        int height = player.getBoundingBox().getHeight();
+
+        //one tick carries the player well past the 2 pixel wall and floor, it must stop right before both
+        player.moveRight();
+        player.update(LONG_TICK, level);
+        CHECK(player.getX() + width < RIGHT_WALL.getLeft());
+        CHECK(player.getX() + width >= RIGHT_WALL.getLeft() - 2);
+        CHECK(player.getY() + height < FLOOR.getTop());
+        CHECK(player.getY() + height >= FLOOR.getTop() - 2);
+
+        //walking back passes under the ledge and stops at the far wall
+        player.moveLeft();
+        player.update(LONG_TICK, level);
+        CHECK(player.getX() > LEFT_WALL.getRight());
+        CHECK(player.getX() <= LEFT_WALL.getRight() + 2);
+        CHECK(player.getY() + height < FLOOR.getTop());
+
+        //longer ticks still don't get through
+        for(int i = 0; i < 10; i++){
+            player.moveRight();
+            player.update(LONG_TICK * 4, level);
+            CHECK(player.getX() + width < RIGHT_WALL.getLeft());
+            CHECK(player.getY() + height < FLOOR.getTop());
+        }
+    }
+    SDL_Quit();
+    return check::result();
+}
@@ -0,0 +1,101 @@
+/**
+ * @file spatialGrid.cpp
+ * @brief Checks SpatialGrid queries against a linear scan, before and after moving entries.
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include "check.h"
+#include "spatialGrid.h"
+
+namespace{
+    const int WORLD_SIZE = 1024;
+    const int CELL_SIZE = 64;
+    const int ENTRY_COUNT = 300;
+    const int QUERY_COUNT = 500;
+
+    uint32_t state = 2024;
+
+    int random(int p_min, int p_max){
+        state = state * 1664525u + 1013904223u;
+        return p_min + (int)((state >> 8) % (uint32_t)(p_max - p_min + 1));
+    }
+
+    Rectangle randomRectangle(){
+        //some rectangles poke out of the world, they're clamped into the border cells
+        return Rectangle(random(-100, WORLD_SIZE + 50), random(-100, WORLD_SIZE + 50), random(0, 150), random(0, 150));
+    }
+
+    /**
+     * @brief Queries the grid and checks the result is sorted, without duplicates, and holds
+     * every rectangle a linear scan finds colliding with the query.
+     */
+    void checkQuery(SpatialGrid &p_grid, const std::vector<Rectangle> &p_rects, const Rectangle &p_query){
+        std::vector<int> ids;
+        ids.push_back(-1); // query() appends, what was already there stays untouched
+        p_grid.query(p_query, ids);
+        CHECK(ids[0] == -1);
+
+        for(int i = 2; i < ids.size(); i++){
+            CHECK(ids[i - 1] < ids[i]);
+        }
+        for(int r = 0; r < p_rects.size(); r++){
+            if(p_rects[r].collidesWith(p_query)){
+                bool found = false;
+                for(int i = 1; i < ids.size(); i++){
+                    found = found || ids[i] == r;
+                }
+                CHECK(found);
+            }
+        }
+    }
+}
+
+int main(){
+    //an empty grid never returns anything
+    SpatialGrid empty;
+    std::vector<int> ids;
+    empty.query(Rectangle(0, 0, 100, 100), ids);
+    CHECK(ids.empty());
+
+    SpatialGrid grid(Vector2f(CELL_SIZE, CELL_SIZE), Vector2f(WORLD_SIZE, WORLD_SIZE));
+    std::vector<Rectangle> rects;
+    for(int i = 0; i < ENTRY_COUNT; i++){
+        rects.push_back(randomRectangle());
+        CHECK(grid.insert(rects.back()) == i);
+    }
+    CHECK(grid.getCount() == ENTRY_COUNT);
+
+    for(int q = 0; q < QUERY_COUNT; q++){
+        checkQuery(grid, rects, randomRectangle());
+    }
+
+    //moves within the same cells and across the world must both be seen by later queries
+    for(int i = 0; i < ENTRY_COUNT; i++){
+        rects[i] = i % 2 == 0 ? Rectangle(rects[i].getLeft() + 1, rects[i].getTop(), rects[i].getWidth(), rects[i].getHeight())
+                              : randomRectangle();
+        grid.move(i, rects[i]);
+    }
+    for(int q = 0; q < QUERY_COUNT; q++){
+        checkQuery(grid, rects, randomRectangle());
+    }
+
+    //an entry moved far away leaves the cells it came from
+    SpatialGrid single(Vector2f(CELL_SIZE, CELL_SIZE), Vector2f(WORLD_SIZE, WORLD_SIZE));
+    int id = single.insert(Rectangle(10, 10, 8, 8));
+    single.move(id, Rectangle(900, 900, 8, 8));
+    ids.clear();
+    single.query(Rectangle(0, 0, 32, 32), ids);
+    CHECK(ids.empty());
+    single.query(Rectangle(890, 890, 32, 32), ids);
+    CHECK(ids.size() == 1 && ids[0] == id);
+
+    grid.clear();
+    CHECK(grid.getCount() == 0);
+    ids.clear();
+    grid.query(Rectangle(0, 0, WORLD_SIZE, WORLD_SIZE), ids);
+    CHECK(ids.empty());
+
+    return check::result();
+}
@@ -0,0 +1,71 @@
+/**
+ * @file tmxEncoding.cpp
+ * @brief Round trips gids through every encoding and compression tmxEncoding supports.
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "check.h"
+#include "tmxEncoding.h"
+
+namespace{
+    const int WIDTH = 37; // odd sizes so rows and base64 groups don't line up
+    const int HEIGHT = 23;
+
+    std::vector<uint32_t> makeGids(){
+        //flip flags in the top bits have to survive the trip too
+        std::vector<uint32_t> gids(WIDTH * HEIGHT);
+        uint32_t state = 12345;
+        for(int i = 0; i < gids.size(); i++){
+            state = state * 1664525u + 1013904223u;
+            gids[i] = i % 5 == 0 ? 0 : (state >> 8) % 300 + 1;
+            if(i % 17 == 0){
+                gids[i] |= 0x80000000u;
+            }
+        }
+        return gids;
+    }
+
+    void checkRoundTrip(const std::vector<uint32_t> &p_gids, const std::string &p_encoding, const std::string &p_compression){
+        std::string text;
+        CHECK(tmxEncoding::encodeGids(p_gids, WIDTH, p_encoding, p_compression, text));
+
+        std::vector<uint32_t> decoded;
+        CHECK(tmxEncoding::decodeGids(text.c_str(), p_encoding, p_compression, p_gids.size(), decoded));
+        CHECK(decoded == p_gids);
+
+        //a cell count that doesn't match the data is an error, not a silent truncation
+        std::vector<uint32_t> wrongSize;
+        CHECK(!tmxEncoding::decodeGids(text.c_str(), p_encoding, p_compression, p_gids.size() + 1, wrongSize));
+    }
+}
+
+int main(){
+    std::vector<uint32_t> gids = makeGids();
+
+    checkRoundTrip(gids, "csv", "");
+    checkRoundTrip(gids, "base64", "");
+    checkRoundTrip(gids, "base64", "zlib");
+    checkRoundTrip(gids, "base64", "gzip");
+    if(tmxEncoding::isCompressionSupported("zstd")){
+        checkRoundTrip(gids, "base64", "zstd");
+    }
+
+    //the encoder refuses what the format can't express
+    std::string text;
+    CHECK(!tmxEncoding::encodeGids(gids, WIDTH, "csv", "zlib", text));
+    CHECK(!tmxEncoding::encodeGids(gids, WIDTH, "xml", "", text));
+    CHECK(!tmxEncoding::encodeGids(gids, WIDTH, "base64", "lzma", text));
+
+    //and the decoder rejects corrupt payloads
+    std::vector<uint32_t> decoded;
+    CHECK(!tmxEncoding::decodeGids("not base64!", "base64", "", gids.size(), decoded));
+    std::string compressed;
+    CHECK(tmxEncoding::encodeGids(gids, WIDTH, "base64", "zlib", compressed));
+    compressed[compressed.size() / 2] = compressed[compressed.size() / 2] == 'A' ? 'B' : 'A';
+    CHECK(!tmxEncoding::decodeGids(compressed.c_str(), "base64", "zlib", gids.size(), decoded) || decoded != gids);
+
+    return check::result();
+}
@@ -0,0 +1,54 @@
+/**
+ * @file mapCooker.cpp
+ * @brief Offline tool converting Tiled .tmx maps into the cooked .cmap format read by MapData::loadCooked.
+ *
+ * Usage: mapcooker <map.tmx>... (each map is written next to its .tmx with the .cmap extension)
+ */
+
+#include <iostream>
+#include <string>
+
+#include "mapData.h"
+
+int main(int argc, char* argv[]){
+    if(argc < 2){
+        std::cout << "Usage: " << argv[0] << " <map.tmx>..." << std::endl;
+        return 1;
+    }
+
+    int failures = 0;
+    for(int i = 1; i < argc; i++){
+        std::string input = argv[i];
+        std::string output = input;
+        std::string::size_type extension = output.rfind(".tmx");
+        if(extension != std::string::npos && extension == output.size() - 4){
+            output.erase(extension);
+        }
+        output += ".cmap";
+
+        MapData map;
+        if(!MapData::loadTmx(input, map)){
+            std::cout << "Error: Unable to parse " << input << std::endl;
+            failures++;
+            continue;
+        }
+        if(map.SourcePositions.empty()){
+            std::cout << "Warning: " << input << " has a tileset without an image size, "
+                "its source positions will be computed at load time" << std::endl;
+        }
+        if(!map.saveCooked(output)){
+            std::cout << "Error: Unable to write " << output << std::endl;
+            failures++;
+            continue;
+        }
+
+        int tiles = 0;
+        for(int l = 0; l < map.Layers.size(); l++){
+            tiles += map.Layers[l].Gids.size();
+        }
+        std::cout << input << " -> " << output << " (" << map.Layers.size() << " layers, " << tiles << " cells, "
+            << map.CollisionRects.size() << " collisions, " << map.Slopes.size() << " slopes, "
+            << map.Doors.size() << " doors, " << map.Enemies.size() << " enemies)" << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,608 @@
+/**
+ * @file mapGenerator.cpp
+ * @brief Offline tool writing synthetic Tiled .tmx maps of any size, to test the loader and benchmark levels.
+ *
+ * Usage: mapgenerator [options] (run with --help for the list)
+ *
+ * Every map has a background layer, a foreground layer holding walls around the map, platforms and
+ * animated tiles, and the object groups the game reads: collisions, slopes, a player spawn point,
+ * doors and enemies. With several maps, the doors link them into a graph: the first door of each
+ * map leads to the next one, so every map can be reached, and the others lead to random maps.
+ * Each written map is loaded back with MapData::loadTmx and compared to what was generated.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "mapData.h"
+#include "tinyxml2.h"
+#include "tmxEncoding.h"
+
+using namespace tinyxml2;
+
+namespace{
+    const int TILE_SIZE = 16;
+    const int CHUNK_SIZE = 16;
+    const int MIN_MAP_SIZE = 8;
+
+    /**
+     * @struct TilesetImage
+     * @brief A tileset image of the game a generated tileset can use.
+     */
+    struct TilesetImage {
+        const char* Name; ///< Name given to the tileset.
+        const char* Source; ///< Image path, as written in the map.
+        int Width; ///< Width of the image in pixels.
+        int Height; ///< Height of the image in pixels.
+        bool Animated; ///< True if the tileset gets the animated tiles below.
+    };
+
+    const TilesetImage TILESET_IMAGES[] = {
+        {"PrtCave", "../res/tilesets/PrtCave.png", 256, 80, false},
+        {"NpcSym", "../res/tilesets/NpcSym.png", 320, 240, true}
+    };
+    const int TILESET_IMAGE_COUNT = sizeof(TILESET_IMAGES) / sizeof(TILESET_IMAGES[0]);
+
+    //the animations of NpcSym in the game's own maps: first tile, frame count and frame duration
+    const int ANIMATED_TILES[][3] = {{18, 2, 500}, {26, 8, 200}};
+    const int ANIMATED_TILE_COUNT = sizeof(ANIMATED_TILES) / sizeof(ANIMATED_TILES[0]);
+
+    const uint32_t BACKGROUND_GIDS[2][2] = {{33, 34}, {49, 50}};
+
+    /**
+     * @struct Encoding
+     * @brief How the gids of a layer are written.
+     */
+    struct Encoding {
+        const char* Name; ///< Name of the encoding on the command line.
+        const char* Attribute; ///< The <data> element's encoding attribute, empty for the legacy XML form.
+        const char* Compression; ///< The <data> element's compression attribute, empty when uncompressed.
+    };
+
+    const Encoding ENCODINGS[] = {
+        {"xml", "", ""},
+        {"csv", "csv", ""},
+        {"base64", "base64", ""},
+        {"zlib", "base64", "zlib"},
+        {"gzip", "base64", "gzip"},
+        {"zstd", "base64", "zstd"}
+    };
+    const int ENCODING_COUNT = sizeof(ENCODINGS) / sizeof(ENCODINGS[0]);
+
+    /**
+     * @struct GeneratorOptions
+     * @brief Settings chosen on the command line.
+     */
+    struct GeneratorOptions {
+        int Width; ///< Width of each map in tiles.
+        int Height; ///< Height of each map in tiles.
+        int Tilesets; ///< Number of tilesets, alternating between the images above.
+        float AnimatedDensity; ///< Share of the empty foreground cells holding an animated tile.
+        int Rects; ///< Platforms, each with its collision rectangle, on top of the four walls.
+        int Slopes; ///< Slopes per map.
+        int Maps; ///< Maps in the door graph.
+        int Doors; ///< Doors per map.
+        int Enemies; ///< Bats per map.
+        bool Infinite; ///< Write infinite maps, whose layers are made of 16x16 chunks.
+        unsigned int Seed; ///< Seed of the generator, the same seed writes the same maps.
+        std::vector<int> Encodings; ///< Indices in ENCODINGS, one set of maps is written per encoding.
+        std::string Name; ///< Name of the maps, numbered when there are several.
+        std::string OutputDirectory; ///< Directory the .tmx files are written to.
+
+        GeneratorOptions() :
+            Width(64),
+            Height(48),
+            Tilesets(2),
+            AnimatedDensity(0.02f),
+            Rects(32),
+            Slopes(8),
+            Maps(1),
+            Doors(-1),
+            Enemies(8),
+            Infinite(false),
+            Seed(1),
+            Name("Generated"),
+            OutputDirectory("../res/maps")
+        {}
+    };
+
+    /**
+     * @struct GeneratedMap
+     * @brief A map as generated, before it's written, in map pixels like the .tmx file.
+     */
+    struct GeneratedMap {
+        std::string Name;
+        std::vector<int> FirstGids;
+        std::vector<uint32_t> Background;
+        std::vector<uint32_t> Foreground;
+        std::vector<Rectangle> CollisionRects;
+        std::vector<Rectangle> Slopes; ///< Start of the slope, then its extent.
+        std::vector<Rectangle> Doors;
+        std::vector<std::string> Destinations;
+        std::vector<Vector2f> Enemies;
+        Vector2f SpawnPoint;
+    };
+
+    int randomInt(std::mt19937 &p_random, int p_min, int p_max){
+        return std::uniform_int_distribution<int>(p_min, std::max(p_min, p_max))(p_random);
+    }
+
+    std::string getMapName(const GeneratorOptions &p_options, int p_encoding, int p_map){
+        std::string name = p_options.Name;
+        if(p_options.Encodings.size() > 1){
+            name += std::string(" ") + ENCODINGS[p_encoding].Name;
+        }
+        if(p_options.Maps > 1){
+            name += " " + std::to_string(p_map + 1);
+        }
+        return name;
+    }
+
+    uint32_t getGroundGid(const GeneratedMap &p_map, int p_tileset){
+        return p_map.FirstGids[p_tileset % p_map.FirstGids.size()];
+    }
+
+    void paintTiles(GeneratedMap &p_map, const GeneratorOptions &p_options, int p_x, int p_y, int p_width, int p_height,
+            uint32_t p_gid){
+        for(int y = p_y; y < p_y + p_height; y++){
+            for(int x = p_x; x < p_x + p_width; x++){
+                p_map.Foreground[(size_t)y * p_options.Width + x] = p_gid;
+            }
+        }
+        p_map.CollisionRects.push_back(Rectangle(p_x * TILE_SIZE, p_y * TILE_SIZE, p_width * TILE_SIZE, p_height * TILE_SIZE));
+    }
+
+    GeneratedMap generateMap(const GeneratorOptions &p_options, int p_encoding, int p_index, std::mt19937 &p_random){
+        GeneratedMap map;
+        map.Name = getMapName(p_options, p_encoding, p_index);
+        int width = p_options.Width;
+        int height = p_options.Height;
+
+        int firstGid = 1;
+        for(int t = 0; t < p_options.Tilesets; t++){
+            const TilesetImage &image = TILESET_IMAGES[t % TILESET_IMAGE_COUNT];
+            map.FirstGids.push_back(firstGid);
+            firstGid += (image.Width / TILE_SIZE) * (image.Height / TILE_SIZE);
+        }
+
+        map.Background.resize((size_t)width * height);
+        map.Foreground.resize((size_t)width * height, 0);
+        for(int y = 0; y < height; y++){
+            for(int x = 0; x < width; x++){
+                map.Background[(size_t)y * width + x] = BACKGROUND_GIDS[y % 2][x % 2];
+            }
+        }
+
+        //walls all around, so nothing falls out of the map
+        paintTiles(map, p_options, 0, 0, width, 1, getGroundGid(map, 0));
+        paintTiles(map, p_options, 0, height - 1, width, 1, getGroundGid(map, 0));
+        paintTiles(map, p_options, 0, 1, 1, height - 2, getGroundGid(map, 0));
+        paintTiles(map, p_options, width - 1, 1, 1, height - 2, getGroundGid(map, 0));
+
+        for(int i = 0; i < p_options.Rects; i++){
+            int length = randomInt(p_random, 2, std::min(8, width - 2));
+            int x = randomInt(p_random, 1, width - 1 - length);
+            int y = randomInt(p_random, 2, height - 3);
+            paintTiles(map, p_options, x, y, length, 1, getGroundGid(map, i));
+        }
+
+        //animated tiles fill the cells left empty, from the tilesets using an animated image
+        std::vector<uint32_t> animatedGids;
+        for(int t = 0; t < p_options.Tilesets; t++){
+            if(TILESET_IMAGES[t % TILESET_IMAGE_COUNT].Animated){
+                for(int a = 0; a < ANIMATED_TILE_COUNT; a++){
+                    animatedGids.push_back(map.FirstGids[t] + ANIMATED_TILES[a][0]);
+                }
+            }
+        }
+        if(!animatedGids.empty() && p_options.AnimatedDensity > 0.0f){
+            std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+            for(size_t i = 0; i < map.Foreground.size(); i++){
+                if(map.Foreground[i] == 0 && chance(p_random) < p_options.AnimatedDensity){
+                    map.Foreground[i] = animatedGids[randomInt(p_random, 0, animatedGids.size() - 1)];
+                }
+            }
+        }
+
+        for(int i = 0; i < p_options.Slopes; i++){
+            int length = randomInt(p_random, 2, std::min(6, width - 2));
+            int x = randomInt(p_random, 1, width - 1 - length);
+            int y = randomInt(p_random, 2, height - 3);
+            int rise = randomInt(p_random, 0, 1) == 0 ? -length / 2 : length / 2;
+            map.Slopes.push_back(Rectangle(x * TILE_SIZE, y * TILE_SIZE, length * TILE_SIZE, std::max(1, std::abs(rise)) *
+                (rise < 0 ? -TILE_SIZE : TILE_SIZE)));
+        }
+
+        int doors = p_options.Doors >= 0 ? p_options.Doors : (p_options.Maps > 1 ? 1 : 0);
+        for(int i = 0; i < doors; i++){
+            int x = randomInt(p_random, 1, width - 2);
+            int y = randomInt(p_random, 1, height - 3);
+            map.Doors.push_back(Rectangle(x * TILE_SIZE, y * TILE_SIZE, TILE_SIZE, TILE_SIZE * 2));
+            int destination = i == 0 ? (p_index + 1) % p_options.Maps : randomInt(p_random, 0, p_options.Maps - 1);
+            map.Destinations.push_back(getMapName(p_options, p_encoding, destination));
+        }
+
+        for(int i = 0; i < p_options.Enemies; i++){
+            map.Enemies.push_back(Vector2f(randomInt(p_random, 1, width - 2) * TILE_SIZE, randomInt(p_random, 1, height - 3) * TILE_SIZE));
+        }
+
+        map.SpawnPoint = Vector2f(width / 2 * TILE_SIZE, (height - 3) * TILE_SIZE);
+        return map;
+    }
+
+    void writeTilesets(XMLPrinter &p_printer, const GeneratorOptions &p_options, const GeneratedMap &p_map){
+        for(int t = 0; t < p_options.Tilesets; t++){
+            const TilesetImage &image = TILESET_IMAGES[t % TILESET_IMAGE_COUNT];
+            std::string name = image.Name;
+            if(t >= TILESET_IMAGE_COUNT){
+                name += std::to_string(t / TILESET_IMAGE_COUNT + 1);
+            }
+
+            p_printer.OpenElement("tileset");
+            p_printer.PushAttribute("firstgid", p_map.FirstGids[t]);
+            p_printer.PushAttribute("name", name.c_str());
+            p_printer.PushAttribute("tilewidth", TILE_SIZE);
+            p_printer.PushAttribute("tileheight", TILE_SIZE);
+            p_printer.OpenElement("image");
+            p_printer.PushAttribute("source", image.Source);
+            p_printer.PushAttribute("width", image.Width);
+            p_printer.PushAttribute("height", image.Height);
+            p_printer.CloseElement();
+
+            for(int a = 0; image.Animated && a < ANIMATED_TILE_COUNT; a++){
+                p_printer.OpenElement("tile");
+                p_printer.PushAttribute("id", ANIMATED_TILES[a][0]);
+                p_printer.OpenElement("animation");
+                for(int f = 0; f < ANIMATED_TILES[a][1]; f++){
+                    p_printer.OpenElement("frame");
+                    p_printer.PushAttribute("tileid", ANIMATED_TILES[a][0] + f);
+                    p_printer.PushAttribute("duration", ANIMATED_TILES[a][2]);
+                    p_printer.CloseElement();
+                }
+                p_printer.CloseElement();
+                p_printer.CloseElement();
+            }
+            p_printer.CloseElement();
+        }
+    }
+
+    bool writeGids(XMLPrinter &p_printer, const Encoding &p_encoding, const std::vector<uint32_t> &p_gids, int p_width){
+        if(p_encoding.Attribute[0] == '\0'){
+            for(size_t i = 0; i < p_gids.size(); i++){
+                p_printer.OpenElement("tile");
+                //like Tiled, empty cells are written without a gid
+                if(p_gids[i] != 0){
+                    p_printer.PushAttribute("gid", p_gids[i]);
+                }
+                p_printer.CloseElement();
+            }
+            return true;
+        }
+
+        std::string text;
+        if(!tmxEncoding::encodeGids(p_gids, p_width, p_encoding.Attribute, p_encoding.Compression, text)){
+            return false;
+        }
+        p_printer.PushText(text.c_str());
+        return true;
+    }
+
+    bool writeLayer(XMLPrinter &p_printer, const GeneratorOptions &p_options, const Encoding &p_encoding,
+            const char* p_name, const std::vector<uint32_t> &p_gids){
+        p_printer.OpenElement("layer");
+        p_printer.PushAttribute("name", p_name);
+        p_printer.PushAttribute("width", p_options.Width);
+        p_printer.PushAttribute("height", p_options.Height);
+        p_printer.OpenElement("data");
+        if(p_encoding.Attribute[0] != '\0'){
+            p_printer.PushAttribute("encoding", p_encoding.Attribute);
+        }
+        if(p_encoding.Compression[0] != '\0'){
+            p_printer.PushAttribute("compression", p_encoding.Compression);
+        }
+
+        bool written = true;
+        if(!p_options.Infinite){
+            written = writeGids(p_printer, p_encoding, p_gids, p_options.Width);
+        } else {
+            //chunks are always whole, cells past the map's edge are empty and chunks with nothing in them are left out
+            std::vector<uint32_t> chunkGids(CHUNK_SIZE * CHUNK_SIZE);
+            for(int chunkY = 0; chunkY < p_options.Height && written; chunkY += CHUNK_SIZE){
+                for(int chunkX = 0; chunkX < p_options.Width && written; chunkX += CHUNK_SIZE){
+                    bool empty = true;
+                    for(int y = 0; y < CHUNK_SIZE; y++){
+                        for(int x = 0; x < CHUNK_SIZE; x++){
+                            bool inside = chunkX + x < p_options.Width && chunkY + y < p_options.Height;
+                            uint32_t gid = inside ? p_gids[(size_t)(chunkY + y) * p_options.Width + chunkX + x] : 0;
+                            chunkGids[y * CHUNK_SIZE + x] = gid;
+                            empty = empty && gid == 0;
+                        }
+                    }
+                    if(empty){
+                        continue;
+                    }
+                    p_printer.OpenElement("chunk");
+                    p_printer.PushAttribute("x", chunkX);
+                    p_printer.PushAttribute("y", chunkY);
+                    p_printer.PushAttribute("width", CHUNK_SIZE);
+                    p_printer.PushAttribute("height", CHUNK_SIZE);
+                    written = writeGids(p_printer, p_encoding, chunkGids, CHUNK_SIZE);
+                    p_printer.CloseElement();
+                }
+            }
+        }
+        p_printer.CloseElement();
+        p_printer.CloseElement();
+        return written;
+    }
+
+    void writeRect(XMLPrinter &p_printer, int &p_nextId, const Rectangle &p_rect){
+        p_printer.OpenElement("object");
+        p_printer.PushAttribute("id", p_nextId++);
+        p_printer.PushAttribute("x", p_rect.getLeft());
+        p_printer.PushAttribute("y", p_rect.getTop());
+        p_printer.PushAttribute("width", p_rect.getWidth());
+        p_printer.PushAttribute("height", p_rect.getHeight());
+    }
+
+    void writeObjects(XMLPrinter &p_printer, const GeneratedMap &p_map){
+        int nextId = 1;
+
+        p_printer.OpenElement("objectgroup");
+        p_printer.PushAttribute("name", "collisions");
+        for(int i = 0; i < p_map.CollisionRects.size(); i++){
+            writeRect(p_printer, nextId, p_map.CollisionRects[i]);
+            p_printer.CloseElement();
+        }
+        p_printer.CloseElement();
+
+        p_printer.OpenElement("objectgroup");
+        p_printer.PushAttribute("name", "spawn points");
+        p_printer.OpenElement("object");
+        p_printer.PushAttribute("id", nextId++);
+        p_printer.PushAttribute("name", "player");
+        p_printer.PushAttribute("x", p_map.SpawnPoint.x);
+        p_printer.PushAttribute("y", p_map.SpawnPoint.y);
+        p_printer.CloseElement();
+        p_printer.CloseElement();
+
+        p_printer.OpenElement("objectgroup");
+        p_printer.PushAttribute("name", "slopes");
+        for(int i = 0; i < p_map.Slopes.size(); i++){
+            const Rectangle &slope = p_map.Slopes[i];
+            std::string points = "0,0 " + std::to_string(slope.getWidth()) + "," + std::to_string(slope.getHeight());
+            p_printer.OpenElement("object");
+            p_printer.PushAttribute("id", nextId++);
+            p_printer.PushAttribute("x", slope.getLeft());
+            p_printer.PushAttribute("y", slope.getTop());
+            p_printer.OpenElement("polyline");
+            p_printer.PushAttribute("points", points.c_str());
+            p_printer.CloseElement();
+            p_printer.CloseElement();
+        }
+        p_printer.CloseElement();
+
+        p_printer.OpenElement("objectgroup");
+        p_printer.PushAttribute("name", "doors");
+        for(int i = 0; i < p_map.Doors.size(); i++){
+            writeRect(p_printer, nextId, p_map.Doors[i]);
+            p_printer.OpenElement("properties");
+            p_printer.OpenElement("property");
+            p_printer.PushAttribute("name", "destination");
+            p_printer.PushAttribute("value", p_map.Destinations[i].c_str());
+            p_printer.CloseElement();
+            p_printer.CloseElement();
+            p_printer.CloseElement();
+        }
+        p_printer.CloseElement();
+
+        p_printer.OpenElement("objectgroup");
+        p_printer.PushAttribute("name", "enemies");
+        for(int i = 0; i < p_map.Enemies.size(); i++){
+            p_printer.OpenElement("object");
+            p_printer.PushAttribute("id", nextId++);
+            p_printer.PushAttribute("name", "bat");
+            p_printer.PushAttribute("x", p_map.Enemies[i].x);
+            p_printer.PushAttribute("y", p_map.Enemies[i].y);
+            p_printer.CloseElement();
+        }
+        p_printer.CloseElement();
+    }
+
+    bool writeMap(const std::string &p_filePath, const GeneratorOptions &p_options, const Encoding &p_encoding,
+            const GeneratedMap &p_map){
+        FILE* file = std::fopen(p_filePath.c_str(), "w");
+        if(file == NULL){
+            return false;
+        }
+
+        XMLPrinter printer(file);
+        printer.PushHeader(false, true);
+        printer.OpenElement("map");
+        printer.PushAttribute("version", "1.0");
+        printer.PushAttribute("orientation", "orthogonal");
+        printer.PushAttribute("renderorder", "right-down");
+        printer.PushAttribute("width", p_options.Width);
+        printer.PushAttribute("height", p_options.Height);
+        printer.PushAttribute("tilewidth", TILE_SIZE);
+        printer.PushAttribute("tileheight", TILE_SIZE);
+        printer.PushAttribute("infinite", p_options.Infinite ? 1 : 0);
+        writeTilesets(printer, p_options, p_map);
+        bool written = writeLayer(printer, p_options, p_encoding, "background", p_map.Background) &&
+            writeLayer(printer, p_options, p_encoding, "foreground", p_map.Foreground);
+        writeObjects(printer, p_map);
+        printer.CloseElement();
+
+        written = std::ferror(file) == 0 && written;
+        return std::fclose(file) == 0 && written;
+    }
+
+    bool verifyMap(const std::string &p_filePath, const GeneratorOptions &p_options, const GeneratedMap &p_map){
+        MapData loaded;
+        if(!MapData::loadTmx(p_filePath, loaded)){
+            return false;
+        }
+
+        //infinite maps load as whole chunks, the cells past the generated size must be empty
+        int width = p_options.Width;
+        int height = p_options.Height;
+        if(p_options.Infinite){
+            width = (width + CHUNK_SIZE - 1) / CHUNK_SIZE * CHUNK_SIZE;
+            height = (height + CHUNK_SIZE - 1) / CHUNK_SIZE * CHUNK_SIZE;
+        }
+        if(loaded.Size.x != width || loaded.Size.y != height || loaded.Layers.size() != 2 ||
+                loaded.Tilesets.size() != p_options.Tilesets || loaded.CollisionRects.size() != p_map.CollisionRects.size() ||
+                loaded.Slopes.size() != p_map.Slopes.size() || loaded.Doors.size() != p_map.Doors.size() ||
+                loaded.Enemies.size() != p_map.Enemies.size()){
+            return false;
+        }
+
+        std::vector<uint32_t> gids;
+        for(int l = 0; l < 2; l++){
+            const std::vector<uint32_t> &expected = l == 0 ? p_map.Background : p_map.Foreground;
+            loaded.getLayerGids(l, gids);
+            if(gids.size() != (size_t)width * height){
+                return false;
+            }
+            for(int y = 0; y < height; y++){
+                for(int x = 0; x < width; x++){
+                    bool inside = x < p_options.Width && y < p_options.Height;
+                    if(gids[(size_t)y * width + x] != (inside ? expected[(size_t)y * p_options.Width + x] : 0)){
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    void printUsage(const char* p_program){
+        std::cout << "Usage: " << p_program << " [options]\n"
+            "  --width N        Width of each map in tiles (default 64)\n"
+            "  --height N       Height of each map in tiles (default 48)\n"
+            "  --tilesets N     Tilesets, alternating between PrtCave and NpcSym (default 2)\n"
+            "  --animated F     Share of the empty foreground cells holding an animated tile (default 0.02)\n"
+            "  --rects N        Platforms with their collision rectangle, on top of the 4 walls (default 32)\n"
+            "  --slopes N       Slopes per map (default 8)\n"
+            "  --maps N         Maps linked together by their doors (default 1)\n"
+            "  --doors N        Doors per map (default 1 with several maps, else 0)\n"
+            "  --enemies N      Bats per map (default 8)\n"
+            "  --encoding E     xml, csv, base64, zlib, gzip, zstd or all (default csv)\n"
+            "  --infinite       Write infinite maps, made of 16x16 chunks\n"
+            "  --seed N         Seed of the generator (default 1)\n"
+            "  --name NAME      Name of the maps, numbered when there are several (default Generated)\n"
+            "  --output DIR     Directory to write the maps to (default ../res/maps)" << std::endl;
+    }
+
+    int findEncoding(const std::string &p_name){
+        for(int i = 0; i < ENCODING_COUNT; i++){
+            if(p_name == ENCODINGS[i].Name){
+                return i;
+            }
+        }
+        return -1;
+    }
+}
+
+int main(int argc, char* argv[]){
+    GeneratorOptions options;
+    std::string encoding = "csv";
+    for(int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        if(arg == "--width" && i + 1 < argc){
+            options.Width = std::atoi(argv[++i]);
+        } else if(arg == "--height" && i + 1 < argc){
+            options.Height = std::atoi(argv[++i]);
+        } else if(arg == "--tilesets" && i + 1 < argc){
+            options.Tilesets = std::atoi(argv[++i]);
+        } else if(arg == "--animated" && i + 1 < argc){
+            options.AnimatedDensity = std::atof(argv[++i]);
+        } else if(arg == "--rects" && i + 1 < argc){
+            options.Rects = std::atoi(argv[++i]);
+        } else if(arg == "--slopes" && i + 1 < argc){
+            options.Slopes = std::atoi(argv[++i]);
+        } else if(arg == "--maps" && i + 1 < argc){
+            options.Maps = std::atoi(argv[++i]);
+        } else if(arg == "--doors" && i + 1 < argc){
+            options.Doors = std::atoi(argv[++i]);
+        } else if(arg == "--enemies" && i + 1 < argc){
+            options.Enemies = std::atoi(argv[++i]);
+        } else if(arg == "--encoding" && i + 1 < argc){
+            encoding = argv[++i];
+        } else if(arg == "--infinite"){
+            options.Infinite = true;
+        } else if(arg == "--seed" && i + 1 < argc){
+            options.Seed = std::strtoul(argv[++i], NULL, 10);
+        } else if(arg == "--name" && i + 1 < argc){
+            options.Name = argv[++i];
+        } else if(arg == "--output" && i + 1 < argc){
+            options.OutputDirectory = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    if(options.Width < MIN_MAP_SIZE || options.Height < MIN_MAP_SIZE){
+        std::cout << "Error: Maps must be at least " << MIN_MAP_SIZE << "x" << MIN_MAP_SIZE << " tiles" << std::endl;
+        return 1;
+    }
+    if(options.Tilesets < 1 || options.Maps < 1 || options.Rects < 0 || options.Slopes < 0 || options.Enemies < 0 ||
+            options.AnimatedDensity < 0.0f || options.AnimatedDensity > 1.0f){
+        std::cout << "Error: Needs at least one tileset and one map, no negative counts and a density between 0 and 1"
+            << std::endl;
+        return 1;
+    }
+    if(options.AnimatedDensity > 0.0f && options.Tilesets < 2){
+        std::cout << "Warning: Animated tiles come from the second tileset, there won't be any" << std::endl;
+    }
+
+    if(encoding == "all"){
+        for(int i = 0; i < ENCODING_COUNT; i++){
+            if(ENCODINGS[i].Compression[0] == '\0' || tmxEncoding::isCompressionSupported(ENCODINGS[i].Compression)){
+                options.Encodings.push_back(i);
+            }
+        }
+    } else {
+        int index = findEncoding(encoding);
+        if(index < 0){
+            std::cout << "Error: Unknown encoding " << encoding << std::endl;
+            return 1;
+        }
+        if(ENCODINGS[index].Compression[0] != '\0' && !tmxEncoding::isCompressionSupported(ENCODINGS[index].Compression)){
+            std::cout << "Error: This build can't write " << encoding << " layers" << std::endl;
+            return 1;
+        }
+        options.Encodings.push_back(index);
+    }
+
+    int failures = 0;
+    for(int e = 0; e < options.Encodings.size(); e++){
+        //every encoding gets the same maps, so they can be compared with each other
+        std::mt19937 random(options.Seed);
+        const Encoding &mapEncoding = ENCODINGS[options.Encodings[e]];
+        for(int m = 0; m < options.Maps; m++){
+            GeneratedMap map = generateMap(options, options.Encodings[e], m, random);
+            std::string filePath = options.OutputDirectory + "/" + map.Name + ".tmx";
+            if(!writeMap(filePath, options, mapEncoding, map)){
+                std::cout << "Error: Unable to write " << filePath << std::endl;
+                failures++;
+                continue;
+            }
+            if(!verifyMap(filePath, options, map)){
+                std::cout << "Error: " << filePath << " doesn't load back as it was generated" << std::endl;
+                failures++;
+                continue;
+            }
+            std::cout << filePath << " (" << mapEncoding.Name << (options.Infinite ? ", infinite" : "") << ", "
+                << options.Width << "x" << options.Height << ", " << map.CollisionRects.size() << " collisions, "
+                << map.Slopes.size() << " slopes, " << map.Doors.size() << " doors, " << map.Enemies.size()
+                << " enemies)" << std::endl;
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}